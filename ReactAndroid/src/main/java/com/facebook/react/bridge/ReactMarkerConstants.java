@@ -66,4 +66,10 @@ public enum ReactMarkerConstants {
   PRE_RUN_JS_BUNDLE_START,
   ATTACH_MEASURED_ROOT_VIEWS_START,
   ATTACH_MEASURED_ROOT_VIEWS_END,
+  CREATE_MODULE_REGISTRY_START,
+  CREATE_MODULE_REGISTRY_END,
+  CREATE_JS_CONTEXT_START,
+  CREATE_JS_CONTEXT_END,
+  LOAD_JS_BUNDLE_START,
+  LOAD_JS_BUNDLE_END,
 }
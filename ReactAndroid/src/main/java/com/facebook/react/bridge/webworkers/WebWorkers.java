@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.bridge.webworkers;
+
+import com.facebook.proguard.annotations.DoNotStrip;
+import com.facebook.react.bridge.queue.MessageQueueThread;
+import com.facebook.react.bridge.queue.MessageQueueThreadImpl;
+import com.facebook.react.bridge.queue.MessageQueueThreadSpec;
+import com.facebook.react.bridge.queue.QueueThreadExceptionHandler;
+
+@DoNotStrip
+public class WebWorkers {
+
+  /**
+   * Creates a new MessageQueueThread for a background web worker owned by the JS thread with the
+   * given MessageQueueThread. Exceptions thrown on the worker are rethrown on the owner's thread
+   * so they go through the bridge's usual exception handling.
+   */
+  @DoNotStrip
+  public static MessageQueueThread createWebWorkerThread(
+      int id,
+      final MessageQueueThread ownerThread) {
+    return MessageQueueThreadImpl.create(
+        MessageQueueThreadSpec.newBackgroundThreadSpec("web-worker-" + id),
+        new QueueThreadExceptionHandler() {
+          @Override
+          public void handleException(final Exception e) {
+            ownerThread.runOnQueue(
+                new Runnable() {
+                  @Override
+                  public void run() {
+                    throw new RuntimeException(e);
+                  }
+                });
+          }
+        });
+  }
+}
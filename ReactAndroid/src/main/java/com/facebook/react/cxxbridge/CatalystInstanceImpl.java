@@ -15,9 +15,11 @@ import java.lang.ref.WeakReference;
 import java.util.ArrayList;
 import java.util.Collection;
 import java.util.concurrent.CopyOnWriteArrayList;
+import java.util.concurrent.atomic.AtomicBoolean;
 import java.util.concurrent.atomic.AtomicInteger;
 
 import android.content.res.AssetManager;
+import android.view.Choreographer;
 
 import com.facebook.common.logging.FLog;
 import com.facebook.infer.annotation.Assertions;
@@ -31,6 +33,7 @@ import com.facebook.react.bridge.NativeArray;
 import com.facebook.react.bridge.NativeModule;
 import com.facebook.react.bridge.NativeModuleCallExceptionHandler;
 import com.facebook.react.bridge.NotThreadSafeBridgeIdleDebugListener;
+import com.facebook.react.bridge.ReadableNativeMap;
 import com.facebook.react.bridge.queue.MessageQueueThread;
 import com.facebook.react.bridge.queue.QueueThreadExceptionHandler;
 import com.facebook.react.bridge.queue.ReactQueueConfiguration;
@@ -77,6 +80,8 @@ public class CatalystInstanceImpl implements CatalystInstance {
   private final ReactQueueConfigurationImpl mReactQueueConfiguration;
   private final CopyOnWriteArrayList<NotThreadSafeBridgeIdleDebugListener> mBridgeIdleListeners;
   private final AtomicInteger mPendingJSCalls = new AtomicInteger(0);
+  private final boolean mIdleNotificationsEnabled;
+  private final AtomicBoolean mIdleFrameCallbackPosted = new AtomicBoolean(false);
   private final String mJsPendingCallsTitleForTrace =
       "pending_js_calls_instance" + sNextInstanceIdForTrace.getAndIncrement();
   private volatile boolean mDestroyed = false;
@@ -122,6 +127,9 @@ public class CatalystInstanceImpl implements CatalystInstance {
     mUIBackgroundQueueThread = mReactQueueConfiguration.getUIBackgroundQueueThread();
     mTraceListener = new JSProfilerTraceListener(this);
 
+    // Lets the bundle be read while the bridge builds its modules and JS context.
+    mJSBundleLoader.prefetchScript(this);
+
     FLog.d(ReactConstants.TAG, "Initializing React Xplat Bridge before initializeBridge");
     initializeBridge(
       new BridgeCallback(this),
@@ -131,6 +139,7 @@ public class CatalystInstanceImpl implements CatalystInstance {
       mUIBackgroundQueueThread,
       mJavaRegistry.getJavaModules(this),
       mJavaRegistry.getCxxModules());
+    mIdleNotificationsEnabled = wantsIdleNotifications();
     FLog.d(ReactConstants.TAG, "Initializing React Xplat Bridge after initializeBridge");
   }
 
@@ -203,8 +212,13 @@ public class CatalystInstanceImpl implements CatalystInstance {
     jniLoadScriptFromFile(fileName, sourceURL);
   }
 
+  /* package */ void prefetchScriptFromFile(String fileName) {
+    jniPrefetchScriptFromFile(fileName);
+  }
+
   private native void jniSetSourceURL(String sourceURL);
   private native void jniLoadScriptFromAssets(AssetManager assetManager, String assetURL);
+  private native void jniPrefetchScriptFromFile(String fileName);
   private native void jniLoadScriptFromFile(String fileName, String sourceURL);
 
   @Override
@@ -368,6 +382,41 @@ public class CatalystInstanceImpl implements CatalystInstance {
   private native void handleMemoryPressureModerate();
   private native void handleMemoryPressureCritical();
 
+  private native boolean wantsIdleNotifications();
+  private native void handleIdle(long deadlineNanos);
+
+  // Displays React Native runs on refresh at 60Hz.
+  private static final long FRAME_INTERVAL_NANOS = 1000000000L / 60;
+
+  private final Choreographer.FrameCallback mIdleFrameCallback = new Choreographer.FrameCallback() {
+    @Override
+    public void doFrame(long frameTimeNanos) {
+      mIdleFrameCallbackPosted.set(false);
+      if (mDestroyed || mPendingJSCalls.get() != 0) {
+        return;
+      }
+      // Frame times come from System.nanoTime(), the clock the executor's
+      // deadline is measured against.
+      handleIdle(frameTimeNanos + FRAME_INTERVAL_NANOS);
+    }
+  };
+
+  /**
+   * Lets the executor use the rest of the next frame once the bridge has gone
+   * idle, e.g. to collect garbage.
+   */
+  private void postIdleNotification() {
+    if (!mIdleFrameCallbackPosted.compareAndSet(false, true)) {
+      return;
+    }
+    mReactQueueConfiguration.getUIQueueThread().runOnQueue(new Runnable() {
+      @Override
+      public void run() {
+        Choreographer.getInstance().postFrameCallback(mIdleFrameCallback);
+      }
+    });
+  }
+
   @Override
   public void handleMemoryPressure(MemoryPressure level) {
     if (mDestroyed) {
@@ -412,6 +461,20 @@ public class CatalystInstanceImpl implements CatalystInstance {
   @Override
   public native long getJavaScriptContext();
 
+  /**
+   * Returns a breakdown of the native memory held by the bridge: process-wide
+   * counters per kind of allocation, and the backlog of the JS queue. Byte
+   * counts are estimates.
+   */
+  public native ReadableNativeMap getMemoryStats();
+
+  /**
+   * Whether getMemoryStats() includes the sizes of call arguments and native
+   * collections. Measuring them costs time on every bridge call, so it is off
+   * by default. The setting is shared by every instance in the process.
+   */
+  public native void setPayloadMemoryStatsEnabled(boolean enabled);
+
   // TODO mhorowitz: add mDestroyed checks to the next three methods
 
   @Override
@@ -423,6 +486,22 @@ public class CatalystInstanceImpl implements CatalystInstance {
   @Override
   public native void stopProfiler(String title, String filename);
 
+  /**
+   * Starts the bridge's built-in tracer, which records native trace sections without
+   * systrace, dropping the events of any earlier session. Each thread keeps its last
+   * eventsPerThread events, or a default number if it is 0. Tracing is shared by every
+   * instance in the process.
+   */
+  public native void startTracing(int eventsPerThread);
+
+  public native void stopTracing();
+
+  /**
+   * Writes the events recorded by the built-in tracer to filename as Chrome trace JSON, which
+   * chrome://tracing and Perfetto open. Can be called while tracing.
+   */
+  public native void writeTrace(String filename);
+
   private void incrementPendingJSCalls() {
     int oldPendingCalls = mPendingJSCalls.getAndIncrement();
     boolean wasIdle = oldPendingCalls == 0;
@@ -462,6 +541,10 @@ public class CatalystInstanceImpl implements CatalystInstance {
         }
       });
     }
+
+    if (isNowIdle && mIdleNotificationsEnabled) {
+      postIdleNotification();
+    }
   }
 
   private void onNativeException(Exception e) {
@@ -48,6 +48,11 @@ public abstract class JSBundleLoader {
       final String fileName,
       final String assetUrl) {
     return new JSBundleLoader() {
+      @Override
+      public void prefetchScript(CatalystInstanceImpl instance) {
+        instance.prefetchScriptFromFile(fileName);
+      }
+
       @Override
       public String loadScript(CatalystInstanceImpl instance) {
         instance.loadScriptFromFile(fileName, assetUrl);
@@ -67,6 +72,11 @@ public abstract class JSBundleLoader {
       final String sourceURL,
       final String cachedFileLocation) {
     return new JSBundleLoader() {
+      @Override
+      public void prefetchScript(CatalystInstanceImpl instance) {
+        instance.prefetchScriptFromFile(cachedFileLocation);
+      }
+
       @Override
       public String loadScript(CatalystInstanceImpl instance) {
         try {
@@ -95,6 +105,13 @@ public abstract class JSBundleLoader {
     };
   }
 
+  /**
+   * Called before the bridge is initialized, so that loaders can start reading their script
+   * while native modules and the JS context are set up. Does nothing by default.
+   */
+  public void prefetchScript(CatalystInstanceImpl instance) {
+  }
+
   /**
    * Loads the script, returning the URL of the source it loaded.
    */
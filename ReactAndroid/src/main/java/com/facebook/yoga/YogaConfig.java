@@ -69,6 +69,32 @@ public class YogaConfig {
     jni_YGConfigSetUseLegacyStretchBehaviour(mNativePointer, useLegacyStretchBehaviour);
   }
 
+  private native void jni_YGConfigSetMeasureCacheCapacity(long nativePointer, int capacity);
+
+  /**
+   * Keeps up to capacity measurements of nodes with a measure cache key, so that nodes with
+   * the same key do not call into Java again under constraints already measured. 0 turns the
+   * cache off.
+   */
+  public void setMeasureCacheCapacity(int capacity) {
+    jni_YGConfigSetMeasureCacheCapacity(mNativePointer, capacity);
+  }
+
+  private native void jni_YGConfigClearMeasureCache(long nativePointer);
+  public void clearMeasureCache() {
+    jni_YGConfigClearMeasureCache(mNativePointer);
+  }
+
+  private native long jni_YGConfigGetMeasureCacheHitCount(long nativePointer);
+  public long getMeasureCacheHitCount() {
+    return jni_YGConfigGetMeasureCacheHitCount(mNativePointer);
+  }
+
+  private native long jni_YGConfigGetMeasureCacheMissCount(long nativePointer);
+  public long getMeasureCacheMissCount() {
+    return jni_YGConfigGetMeasureCacheMissCount(mNativePointer);
+  }
+
   private native void jni_YGConfigSetLogger(long nativePointer, Object logger);
   public void setLogger(YogaLogger logger) {
     mLogger = logger;
@@ -11,6 +11,8 @@ package com.facebook.yoga;
 
 import javax.annotation.Nullable;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.List;
 import java.util.ArrayList;
 
@@ -41,6 +43,18 @@ public class YogaNode {
   private final static int PADDING = 2;
   private final static int BORDER = 4;
 
+  /* Offsets into the records written by calculateLayoutPacked, in sync with YGJNI.cpp */
+  private final static int PACKED_NEW_LAYOUT_CHILD_COUNT = 1 * 4;
+  private final static int PACKED_DIRECTION = 2 * 4;
+  private final static int PACKED_WIDTH = 3 * 4;
+  private final static int PACKED_HEIGHT = 4 * 4;
+  private final static int PACKED_LEFT = 5 * 4;
+  private final static int PACKED_TOP = 6 * 4;
+  private final static int PACKED_MARGIN = 7 * 4;
+  private final static int PACKED_PADDING = 11 * 4;
+  private final static int PACKED_BORDER = 15 * 4;
+  private final static int PACKED_RECORD_SIZE = 19 * 4;
+
   @DoNotStrip
   private int mEdgeSetFlag = 0;
 
@@ -83,6 +97,9 @@ public class YogaNode {
   @DoNotStrip
   private boolean mHasNewLayout = true;
 
+  // Only allocated for roots laid out with calculateLayoutPacked.
+  private @Nullable ByteBuffer mPackedLayoutOutputs;
+
   private native long jni_YGNodeNew();
   public YogaNode() {
     mNativePointer = jni_YGNodeNew();
@@ -184,6 +201,72 @@ public class YogaNode {
     jni_YGNodeCalculateLayout(mNativePointer, width, height);
   }
 
+  private native int jni_YGNodeCalculateLayoutPacked(
+      long nativePointer,
+      float width,
+      float height,
+      @Nullable ByteBuffer outputs);
+  private native int jni_YGNodePackLayoutOutputs(long nativePointer, ByteBuffer outputs);
+
+  /**
+   * Same as {@link #calculateLayout}, but the results of all nodes with a new layout are handed
+   * over in a single buffer instead of being set field by field from native code.
+   */
+  public void calculateLayoutPacked(float width, float height) {
+    int count = jni_YGNodeCalculateLayoutPacked(mNativePointer, width, height, mPackedLayoutOutputs);
+    if (count < 0) {
+      mPackedLayoutOutputs = ByteBuffer.allocateDirect(-count * PACKED_RECORD_SIZE * 5 / 4)
+          .order(ByteOrder.nativeOrder());
+      count = jni_YGNodePackLayoutOutputs(mNativePointer, mPackedLayoutOutputs);
+    }
+    if (count > 0) {
+      readPackedLayoutOutputs(mPackedLayoutOutputs, 0);
+    }
+  }
+
+  /**
+   * Applies the record at offset and those of the descendants following it, returning the
+   * offset past them.
+   */
+  private int readPackedLayoutOutputs(ByteBuffer outputs, int offset) {
+    mLayoutDirection = outputs.getInt(offset + PACKED_DIRECTION);
+    mWidth = outputs.getFloat(offset + PACKED_WIDTH);
+    mHeight = outputs.getFloat(offset + PACKED_HEIGHT);
+    mLeft = outputs.getFloat(offset + PACKED_LEFT);
+    mTop = outputs.getFloat(offset + PACKED_TOP);
+
+    if ((mEdgeSetFlag & MARGIN) == MARGIN) {
+      mMarginLeft = outputs.getFloat(offset + PACKED_MARGIN);
+      mMarginTop = outputs.getFloat(offset + PACKED_MARGIN + 4);
+      mMarginRight = outputs.getFloat(offset + PACKED_MARGIN + 8);
+      mMarginBottom = outputs.getFloat(offset + PACKED_MARGIN + 12);
+    }
+
+    if ((mEdgeSetFlag & PADDING) == PADDING) {
+      mPaddingLeft = outputs.getFloat(offset + PACKED_PADDING);
+      mPaddingTop = outputs.getFloat(offset + PACKED_PADDING + 4);
+      mPaddingRight = outputs.getFloat(offset + PACKED_PADDING + 8);
+      mPaddingBottom = outputs.getFloat(offset + PACKED_PADDING + 12);
+    }
+
+    if ((mEdgeSetFlag & BORDER) == BORDER) {
+      mBorderLeft = outputs.getFloat(offset + PACKED_BORDER);
+      mBorderTop = outputs.getFloat(offset + PACKED_BORDER + 4);
+      mBorderRight = outputs.getFloat(offset + PACKED_BORDER + 8);
+      mBorderBottom = outputs.getFloat(offset + PACKED_BORDER + 12);
+    }
+
+    mHasNewLayout = true;
+
+    final int newLayoutChildCount = outputs.getInt(offset + PACKED_NEW_LAYOUT_CHILD_COUNT);
+    offset += PACKED_RECORD_SIZE;
+    for (int i = 0; i < newLayoutChildCount; i++) {
+      // Records start with the index of their node in its parent.
+      offset = mChildren.get(outputs.getInt(offset)).readPackedLayoutOutputs(outputs, offset);
+    }
+    return offset;
+  }
+
   public boolean hasNewLayout() {
     return mHasNewLayout;
   }
@@ -407,6 +490,30 @@ public class YogaNode {
     jni_YGNodeStyleSetBorder(mNativePointer, edge.intValue(), border);
   }
 
+  /**
+   * Called for every change added to a {@link YogaStyleBatch}, which bypasses the setters. Returns
+   * the native node the change is applied to.
+   */
+  long onStyleBatched(YogaStyleProperty property) {
+    switch (property) {
+      case MARGIN:
+        mEdgeSetFlag |= MARGIN;
+        break;
+      case PADDING:
+        mEdgeSetFlag |= PADDING;
+        break;
+      case BORDER:
+        mEdgeSetFlag |= BORDER;
+        break;
+      case POSITION:
+        mHasSetPosition = true;
+        break;
+      default:
+        break;
+    }
+    return mNativePointer;
+  }
+
   private native Object jni_YGNodeStyleGetPosition(long nativePointer, int edge);
   public YogaValue getPosition(YogaEdge edge) {
     if (!mHasSetPosition) {
@@ -639,6 +746,18 @@ public class YogaNode {
           YogaMeasureMode.fromInt(heightMode));
   }
 
+  private native void jni_YGNodeSetMeasureCacheKey(long nativePointer, long key);
+
+  /**
+   * Lets nodes whose measure functions would measure the same content share measurements
+   * through their config's measure cache, see {@link YogaConfig#setMeasureCacheCapacity}. The
+   * key must change whenever what the node measures does, for instance a hash of its text and
+   * text style. 0 keeps the node out of the cache.
+   */
+  public void setMeasureCacheKey(long key) {
+    jni_YGNodeSetMeasureCacheKey(mNativePointer, key);
+  }
+
   private native void jni_YGNodeSetHasBaselineFunc(long nativePointer, boolean hasMeasureFunc);
   public void setBaselineFunction(YogaBaselineFunction baselineFunction) {
     mBaselineFunction = baselineFunction;
@@ -671,4 +790,15 @@ public class YogaNode {
   public void print() {
     jni_YGNodePrint(mNativePointer);
   }
+
+  private native byte[] jni_YGNodeSerialize(long nativePointer, boolean includeLayout);
+
+  /**
+   * Captures the config, styles and, if includeLayout, the layouts of this node and its
+   * descendants, in the format read by YGNodeDeserialize. Measure and baseline functions are not
+   * part of the snapshot.
+   */
+  public byte[] serializeSnapshot(boolean includeLayout) {
+    return jni_YGNodeSerialize(mNativePointer, includeLayout);
+  }
 }
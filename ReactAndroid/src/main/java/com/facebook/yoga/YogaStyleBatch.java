@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.yoga;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+
+import com.facebook.proguard.annotations.DoNotStrip;
+import com.facebook.soloader.SoLoader;
+
+/**
+ * Collects style changes for any number of nodes and applies them with a single native call,
+ * instead of one call per property. Nodes are only marked dirty by changes to a different value.
+ */
+@DoNotStrip
+public class YogaStyleBatch {
+
+  static {
+    SoLoader.loadLibrary("yoga");
+  }
+
+  /* Record layout, in sync with YGJNI.cpp */
+  private final static int NODE = 0;
+  private final static int PROPERTY = 8;
+  private final static int EDGE = 12;
+  private final static int UNIT = 16;
+  private final static int VALUE = 20;
+  private final static int RECORD_SIZE = 24;
+
+  private ByteBuffer mRecords;
+  private int mCount;
+  // Records only hold native pointers, so the nodes are kept alive here until they are applied.
+  private final ArrayList<YogaNode> mNodes = new ArrayList<>();
+
+  public YogaStyleBatch() {
+    this(64);
+  }
+
+  public YogaStyleBatch(int initialCapacity) {
+    mRecords = ByteBuffer.allocateDirect(Math.max(initialCapacity, 1) * RECORD_SIZE)
+        .order(ByteOrder.nativeOrder());
+  }
+
+  /**
+   * Sets a property that takes no unit or edge. Enum properties take the int value of the enum.
+   */
+  public YogaStyleBatch set(YogaNode node, YogaStyleProperty property, float value) {
+    return set(node, property, YogaEdge.ALL, value, YogaUnit.POINT);
+  }
+
+  public YogaStyleBatch set(YogaNode node, YogaStyleProperty property, float value, YogaUnit unit) {
+    return set(node, property, YogaEdge.ALL, value, unit);
+  }
+
+  /**
+   * Sets a property, reading edge only for margin, padding, border and position. A unit of
+   * {@link YogaUnit#UNDEFINED} resets the property.
+   */
+  public YogaStyleBatch set(
+      YogaNode node,
+      YogaStyleProperty property,
+      YogaEdge edge,
+      float value,
+      YogaUnit unit) {
+    if ((mCount + 1) * RECORD_SIZE > mRecords.capacity()) {
+      final ByteBuffer records = ByteBuffer.allocateDirect(mRecords.capacity() * 2)
+          .order(ByteOrder.nativeOrder());
+      mRecords.position(0);
+      mRecords.limit(mCount * RECORD_SIZE);
+      records.put(mRecords);
+      mRecords = records;
+    }
+
+    final long nativePointer = node.onStyleBatched(property);
+    mNodes.add(node);
+
+    final int offset = mCount * RECORD_SIZE;
+    mRecords.putLong(offset + NODE, nativePointer);
+    mRecords.putInt(offset + PROPERTY, property.intValue());
+    mRecords.putInt(offset + EDGE, edge.intValue());
+    mRecords.putInt(offset + UNIT, unit.intValue());
+    mRecords.putFloat(offset + VALUE, value);
+    mCount++;
+    return this;
+  }
+
+  public int size() {
+    return mCount;
+  }
+
+  private static native int jni_YGNodeApplyStyleBatch(ByteBuffer records, int count);
+
+  /**
+   * Applies the collected changes in order and empties the batch. Returns the number of changes
+   * that set a property to a different value.
+   */
+  public int apply() {
+    final int changes = jni_YGNodeApplyStyleBatch(mRecords, mCount);
+    mCount = 0;
+    mNodes.clear();
+    return changes;
+  }
+}
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.yoga;
+
+import com.facebook.proguard.annotations.DoNotStrip;
+
+@DoNotStrip
+public enum YogaStyleProperty {
+  DIRECTION(0),
+  FLEX_DIRECTION(1),
+  JUSTIFY_CONTENT(2),
+  ALIGN_CONTENT(3),
+  ALIGN_ITEMS(4),
+  ALIGN_SELF(5),
+  POSITION_TYPE(6),
+  FLEX_WRAP(7),
+  OVERFLOW(8),
+  DISPLAY(9),
+  FLEX(10),
+  FLEX_GROW(11),
+  FLEX_SHRINK(12),
+  FLEX_BASIS(13),
+  POSITION(14),
+  MARGIN(15),
+  PADDING(16),
+  BORDER(17),
+  WIDTH(18),
+  HEIGHT(19),
+  MIN_WIDTH(20),
+  MIN_HEIGHT(21),
+  MAX_WIDTH(22),
+  MAX_HEIGHT(23),
+  ASPECT_RATIO(24);
+
+  private int mIntValue;
+
+  YogaStyleProperty(int intValue) {
+    mIntValue = intValue;
+  }
+
+  public int intValue() {
+    return mIntValue;
+  }
+
+  public static YogaStyleProperty fromInt(int value) {
+    switch (value) {
+      case 0: return DIRECTION;
+      case 1: return FLEX_DIRECTION;
+      case 2: return JUSTIFY_CONTENT;
+      case 3: return ALIGN_CONTENT;
+      case 4: return ALIGN_ITEMS;
+      case 5: return ALIGN_SELF;
+      case 6: return POSITION_TYPE;
+      case 7: return FLEX_WRAP;
+      case 8: return OVERFLOW;
+      case 9: return DISPLAY;
+      case 10: return FLEX;
+      case 11: return FLEX_GROW;
+      case 12: return FLEX_SHRINK;
+      case 13: return FLEX_BASIS;
+      case 14: return POSITION;
+      case 15: return MARGIN;
+      case 16: return PADDING;
+      case 17: return BORDER;
+      case 18: return WIDTH;
+      case 19: return HEIGHT;
+      case 20: return MIN_WIDTH;
+      case 21: return MIN_HEIGHT;
+      case 22: return MAX_WIDTH;
+      case 23: return MAX_HEIGHT;
+      case 24: return ASPECT_RATIO;
+      default: throw new IllegalArgumentException("Unknown enum value: " + value);
+    }
+  }
+}
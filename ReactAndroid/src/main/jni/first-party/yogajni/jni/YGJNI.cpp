@@ -8,7 +8,11 @@
  */
 
 #include <fb/fbjni.h>
+#include <fb/fbjni/ByteBuffer.h>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <vector>
 #include <yoga/Yoga.h>
 
 using namespace facebook::jni;
@@ -18,13 +22,101 @@ struct JYogaNode : public JavaClass<JYogaNode> {
   static constexpr auto kJavaDescriptor = "Lcom/facebook/yoga/YogaNode;";
 };
 
+class YGJNILayoutScope;
+
+struct YGJNINodeContext {
+  weak_ref<jobject> javaNode;
+  // Only set on the root of a tree during its layout.
+  YGJNILayoutScope *layoutScope;
+  // Only set during a layout, once the node's measure or baseline function has been called.
+  jobject layoutJavaNode;
+  // Last value given to the Java node's mLayoutDirection.
+  YGDirection transferredDirection;
+};
+
+static inline YGJNINodeContext *YGNodeJNIContext(YGNodeRef node) {
+  return reinterpret_cast<YGJNINodeContext *>(YGNodeGetContext(node));
+}
+
 static inline weak_ref<JYogaNode> *YGNodeJobject(YGNodeRef node) {
-  return reinterpret_cast<weak_ref<JYogaNode> *>(YGNodeGetContext(node));
+  return reinterpret_cast<weak_ref<JYogaNode> *>(&YGNodeJNIContext(node)->javaNode);
+}
+
+static YGJNINodeContext *YGJNINodeContextNew(alias_ref<jobject> thiz) {
+  return new YGJNINodeContext{make_weak(thiz), nullptr, nullptr, YGDirectionInherit};
+}
+
+// Keeps strong references to the Java nodes whose measure or baseline functions are called
+// during a layout, so that their weak references are only promoted on the first call. They live
+// in a local frame of their own, popped with the scope. Pre-O ART allows 512 local references
+// per thread, so the frame is capped, and nodes past the cap promote on every call instead.
+// Parallel layout is not available from Java, so callbacks always run on the thread owning the
+// frame.
+class YGJNILayoutScope {
+ public:
+  explicit YGJNILayoutScope(YGNodeRef root)
+      : root_(root), frame_(Environment::current(), kMaxJavaNodes) {
+    YGNodeJNIContext(root_)->layoutScope = this;
+  }
+
+  ~YGJNILayoutScope() {
+    for (YGJNINodeContext *const context : promoted_) {
+      context->layoutJavaNode = nullptr;
+    }
+    YGNodeJNIContext(root_)->layoutScope = nullptr;
+  }
+
+  // Returns the Java node of context, or null if it was collected or the frame is full.
+  jobject promote(YGJNINodeContext *context) {
+    if (promoted_.size() == kMaxJavaNodes) {
+      return nullptr;
+    }
+    const jobject javaNode = context->javaNode.lockLocal().release();
+    if (javaNode != nullptr) {
+      context->layoutJavaNode = javaNode;
+      promoted_.push_back(context);
+    }
+    return javaNode;
+  }
+
+ private:
+  static constexpr size_t kMaxJavaNodes = 128;
+
+  const YGNodeRef root_;
+  vector<YGJNINodeContext *> promoted_;
+  JniLocalScope frame_;
+};
+
+// Returns the Java node for a measure or baseline call. Unless it is held by the layout scope of
+// its tree, its weak reference is promoted into locked, which has to outlive the result.
+static alias_ref<jobject> YGNodeCallbackJobject(YGNodeRef node, local_ref<jobject> &locked) {
+  YGJNINodeContext *const context = YGNodeJNIContext(node);
+  if (context->layoutJavaNode != nullptr) {
+    return context->layoutJavaNode;
+  }
+
+  YGNodeRef root = node;
+  while (YGNodeGetParent(root) != nullptr) {
+    root = YGNodeGetParent(root);
+  }
+  if (YGJNILayoutScope *const scope = YGNodeJNIContext(root)->layoutScope) {
+    if (const jobject javaNode = scope->promote(context)) {
+      return javaNode;
+    }
+  }
+  locked = context->javaNode.lockLocal();
+  return locked;
 }
 
 static void YGTransferLayoutDirection(YGNodeRef node, alias_ref<jobject> javaNode) {
+  YGJNINodeContext *const context = YGNodeJNIContext(node);
+  const YGDirection direction = YGNodeLayoutGetDirection(node);
+  if (context->transferredDirection == direction) {
+    return;
+  }
   static auto layoutDirectionField = javaNode->getClass()->getField<jint>("mLayoutDirection");
-  javaNode->setFieldValue(layoutDirectionField, static_cast<jint>(YGNodeLayoutGetDirection(node)));
+  javaNode->setFieldValue(layoutDirectionField, static_cast<jint>(direction));
+  context->transferredDirection = direction;
 }
 
 static void YGTransferLayoutOutputsRecursive(YGNodeRef root) {
@@ -99,6 +191,94 @@ static void YGTransferLayoutOutputsRecursive(YGNodeRef root) {
   }
 }
 
+/* Layout of the records written by YGPackLayoutOutputsRecursive, in 32 bit words. Needs to be
+ * in sync with YogaNode.java */
+enum YGPackedLayoutOutput {
+  YGPackedLayoutOutputChildIndex,
+  YGPackedLayoutOutputNewLayoutChildCount,
+  YGPackedLayoutOutputDirection,
+  YGPackedLayoutOutputWidth,
+  YGPackedLayoutOutputHeight,
+  YGPackedLayoutOutputLeft,
+  YGPackedLayoutOutputTop,
+  YGPackedLayoutOutputMargin,
+  YGPackedLayoutOutputPadding = YGPackedLayoutOutputMargin + 4,
+  YGPackedLayoutOutputBorder = YGPackedLayoutOutputPadding + 4,
+  YGPackedLayoutOutputWordCount = YGPackedLayoutOutputBorder + 4,
+};
+
+static uint32_t YGCountNewLayoutsRecursive(YGNodeRef root) {
+  if (!YGNodeGetHasNewLayout(root)) {
+    return 0;
+  }
+  uint32_t count = 1;
+  for (uint32_t i = 0; i < YGNodeGetChildCount(root); i++) {
+    count += YGCountNewLayoutsRecursive(YGNodeGetChild(root, i));
+  }
+  return count;
+}
+
+static inline void YGPackFloat(int32_t *words, int index, float value) {
+  memcpy(&words[index], &value, sizeof(float));
+}
+
+// Writes a record for root and each of its descendants with a new layout, parents before their
+// children, visiting the same nodes as YGTransferLayoutOutputsRecursive. Each record is
+// followed by those of its children, whose count it holds.
+static int32_t *YGPackLayoutOutputsRecursive(YGNodeRef root, uint32_t childIndex, int32_t *out) {
+  int32_t *const words = out;
+  const uint32_t childCount = YGNodeGetChildCount(root);
+  uint32_t newLayoutChildCount = 0;
+  for (uint32_t i = 0; i < childCount; i++) {
+    if (YGNodeGetHasNewLayout(YGNodeGetChild(root, i))) {
+      newLayoutChildCount++;
+    }
+  }
+
+  words[YGPackedLayoutOutputChildIndex] = static_cast<int32_t>(childIndex);
+  words[YGPackedLayoutOutputNewLayoutChildCount] = static_cast<int32_t>(newLayoutChildCount);
+  words[YGPackedLayoutOutputDirection] = static_cast<int32_t>(YGNodeLayoutGetDirection(root));
+  YGNodeJNIContext(root)->transferredDirection = YGNodeLayoutGetDirection(root);
+  YGPackFloat(words, YGPackedLayoutOutputWidth, YGNodeLayoutGetWidth(root));
+  YGPackFloat(words, YGPackedLayoutOutputHeight, YGNodeLayoutGetHeight(root));
+  YGPackFloat(words, YGPackedLayoutOutputLeft, YGNodeLayoutGetLeft(root));
+  YGPackFloat(words, YGPackedLayoutOutputTop, YGNodeLayoutGetTop(root));
+
+  // Java only reads the edges it has set, but checking that here would cost a JNI call.
+  static const YGEdge edges[4] = {YGEdgeLeft, YGEdgeTop, YGEdgeRight, YGEdgeBottom};
+  for (int i = 0; i < 4; i++) {
+    YGPackFloat(words, YGPackedLayoutOutputMargin + i, YGNodeLayoutGetMargin(root, edges[i]));
+    YGPackFloat(words, YGPackedLayoutOutputPadding + i, YGNodeLayoutGetPadding(root, edges[i]));
+    YGPackFloat(words, YGPackedLayoutOutputBorder + i, YGNodeLayoutGetBorder(root, edges[i]));
+  }
+
+  YGNodeSetHasNewLayout(root, false);
+  out += YGPackedLayoutOutputWordCount;
+
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeGetChild(root, i);
+    if (YGNodeGetHasNewLayout(child)) {
+      out = YGPackLayoutOutputsRecursive(child, i, out);
+    }
+  }
+  return out;
+}
+
+// Returns the number of records written, or minus the number needed if outputs is too small,
+// in which case nothing is written.
+static jint YGPackLayoutOutputs(YGNodeRef root, alias_ref<JByteBuffer> outputs) {
+  const uint32_t count = YGCountNewLayoutsRecursive(root);
+  if (count == 0) {
+    return 0;
+  }
+  const size_t size = count * YGPackedLayoutOutputWordCount * sizeof(int32_t);
+  if (!outputs || outputs->getDirectSize() < size) {
+    return -static_cast<jint>(count);
+  }
+  YGPackLayoutOutputsRecursive(root, 0, reinterpret_cast<int32_t *>(outputs->getDirectBytes()));
+  return static_cast<jint>(count);
+}
+
 static void YGPrint(YGNodeRef node) {
   if (auto obj = YGNodeJobject(node)->lockLocal()) {
     cout << obj->toString() << endl;
@@ -108,7 +288,8 @@ static void YGPrint(YGNodeRef node) {
 }
 
 static float YGJNIBaselineFunc(YGNodeRef node, float width, float height) {
-  if (auto obj = YGNodeJobject(node)->lockLocal()) {
+  local_ref<jobject> locked;
+  if (auto obj = YGNodeCallbackJobject(node, locked)) {
     static auto baselineFunc = findClassStatic("com/facebook/yoga/YogaNode")
                                    ->getMethod<jfloat(jfloat, jfloat)>("baseline");
     return baselineFunc(obj, width, height);
@@ -122,7 +303,8 @@ static YGSize YGJNIMeasureFunc(YGNodeRef node,
                                YGMeasureMode widthMode,
                                float height,
                                YGMeasureMode heightMode) {
-  if (auto obj = YGNodeJobject(node)->lockLocal()) {
+  local_ref<jobject> locked;
+  if (auto obj = YGNodeCallbackJobject(node, locked)) {
     static auto measureFunc = findClassStatic("com/facebook/yoga/YogaNode")
                                   ->getMethod<jlong(jfloat, jint, jfloat, jint)>("measure");
 
@@ -188,28 +370,30 @@ static inline YGConfigRef _jlong2YGConfigRef(jlong addr) {
 
 jlong jni_YGNodeNew(alias_ref<jobject> thiz) {
   const YGNodeRef node = YGNodeNew();
-  YGNodeSetContext(node, new weak_ref<jobject>(make_weak(thiz)));
+  YGNodeSetContext(node, YGJNINodeContextNew(thiz));
   YGNodeSetPrintFunc(node, YGPrint);
   return reinterpret_cast<jlong>(node);
 }
 
 jlong jni_YGNodeNewWithConfig(alias_ref<jobject> thiz, jlong configPointer) {
   const YGNodeRef node = YGNodeNewWithConfig(_jlong2YGConfigRef(configPointer));
-  YGNodeSetContext(node, new weak_ref<jobject>(make_weak(thiz)));
+  YGNodeSetContext(node, YGJNINodeContextNew(thiz));
   YGNodeSetPrintFunc(node, YGPrint);
   return reinterpret_cast<jlong>(node);
 }
 
 void jni_YGNodeFree(alias_ref<jobject> thiz, jlong nativePointer) {
   const YGNodeRef node = _jlong2YGNodeRef(nativePointer);
-  delete YGNodeJobject(node);
+  delete YGNodeJNIContext(node);
   YGNodeFree(node);
 }
 
 void jni_YGNodeReset(alias_ref<jobject> thiz, jlong nativePointer) {
   const YGNodeRef node = _jlong2YGNodeRef(nativePointer);
-  void *context = YGNodeGetContext(node);
+  YGJNINodeContext *const context = YGNodeJNIContext(node);
   YGNodeReset(node);
+  // The Java node resets its layout direction too.
+  context->transferredDirection = YGDirectionInherit;
   YGNodeSetContext(node, context);
   YGNodeSetPrintFunc(node, YGPrint);
 }
@@ -234,13 +418,81 @@ void jni_YGNodeCalculateLayout(alias_ref<jobject>,
                                jfloat width,
                                jfloat height) {
   const YGNodeRef root = _jlong2YGNodeRef(nativePointer);
-  YGNodeCalculateLayout(root,
-                        static_cast<float>(width),
-                        static_cast<float>(height),
-                        YGNodeStyleGetDirection(_jlong2YGNodeRef(nativePointer)));
+  {
+    YGJNILayoutScope scope(root);
+    YGNodeCalculateLayout(root,
+                          static_cast<float>(width),
+                          static_cast<float>(height),
+                          YGNodeStyleGetDirection(_jlong2YGNodeRef(nativePointer)));
+  }
   YGTransferLayoutOutputsRecursive(root);
 }
 
+jint jni_YGNodeCalculateLayoutPacked(alias_ref<jobject>,
+                                     jlong nativePointer,
+                                     jfloat width,
+                                     jfloat height,
+                                     alias_ref<JByteBuffer> outputs) {
+  const YGNodeRef root = _jlong2YGNodeRef(nativePointer);
+  {
+    YGJNILayoutScope scope(root);
+    YGNodeCalculateLayout(root,
+                          static_cast<float>(width),
+                          static_cast<float>(height),
+                          YGNodeStyleGetDirection(root));
+  }
+  return YGPackLayoutOutputs(root, outputs);
+}
+
+jint jni_YGNodePackLayoutOutputs(alias_ref<jobject>,
+                                 jlong nativePointer,
+                                 alias_ref<JByteBuffer> outputs) {
+  return YGPackLayoutOutputs(_jlong2YGNodeRef(nativePointer), outputs);
+}
+
+local_ref<JArrayByte> jni_YGNodeSerialize(alias_ref<jobject>,
+                                          jlong nativePointer,
+                                          jboolean includeLayout) {
+  const YGNodeRef node = _jlong2YGNodeRef(nativePointer);
+  const size_t size = YGNodeSerialize(node, includeLayout, nullptr, 0);
+  vector<jbyte> snapshot(size);
+  YGNodeSerialize(node, includeLayout, snapshot.data(), size);
+
+  auto array = JArrayByte::newArray(size);
+  array->setRegion(0, static_cast<jsize>(size), snapshot.data());
+  return array;
+}
+
+/* Record layout of YogaStyleBatch.java */
+struct YGJNIStyleRecord {
+  jlong node;
+  jint property;
+  jint edge;
+  jint unit;
+  jfloat value;
+};
+static_assert(sizeof(YGJNIStyleRecord) == 24, "Expected style records to be 24 bytes");
+
+jint jni_YGNodeApplyStyleBatch(alias_ref<jclass>, alias_ref<JByteBuffer> records, jint count) {
+  const auto *const packed = reinterpret_cast<const YGJNIStyleRecord *>(records->getDirectBytes());
+
+  YGStyleUpdate updates[64];
+  jint changes = 0;
+  for (jint start = 0; start < count; start += 64) {
+    const uint32_t chunk = static_cast<uint32_t>(std::min(count - start, 64));
+    for (uint32_t i = 0; i < chunk; i++) {
+      const YGJNIStyleRecord &record = packed[start + i];
+      updates[i].node = _jlong2YGNodeRef(record.node);
+      updates[i].property = static_cast<YGStyleProperty>(record.property);
+      updates[i].edge = static_cast<YGEdge>(record.edge);
+      updates[i].unit = static_cast<YGUnit>(record.unit);
+      updates[i].value = record.value;
+    }
+    changes += static_cast<jint>(YGNodeApplyStyleBatch(updates, chunk));
+  }
+  return changes;
+}
+
 void jni_YGNodeMarkDirty(alias_ref<jobject>, jlong nativePointer) {
   YGNodeMarkDirty(_jlong2YGNodeRef(nativePointer));
 }
@@ -253,6 +505,10 @@ void jni_YGNodeSetHasMeasureFunc(alias_ref<jobject>, jlong nativePointer, jboole
   YGNodeSetMeasureFunc(_jlong2YGNodeRef(nativePointer), hasMeasureFunc ? YGJNIMeasureFunc : NULL);
 }
 
+void jni_YGNodeSetMeasureCacheKey(alias_ref<jobject>, jlong nativePointer, jlong key) {
+  YGNodeSetMeasureCacheKey(_jlong2YGNodeRef(nativePointer), static_cast<uint64_t>(key));
+}
+
 void jni_YGNodeSetHasBaselineFunc(alias_ref<jobject>,
                                   jlong nativePointer,
                                   jboolean hasBaselineFunc) {
@@ -417,6 +673,23 @@ void jni_YGConfigSetUseLegacyStretchBehaviour(alias_ref<jobject>,
   YGConfigSetUseLegacyStretchBehaviour(config, useLegacyStretchBehaviour);
 }
 
+void jni_YGConfigSetMeasureCacheCapacity(alias_ref<jobject>, jlong nativePointer, jint capacity) {
+  YGConfigSetMeasureCacheCapacity(_jlong2YGConfigRef(nativePointer),
+                                  static_cast<uint32_t>(capacity));
+}
+
+void jni_YGConfigClearMeasureCache(alias_ref<jobject>, jlong nativePointer) {
+  YGConfigClearMeasureCache(_jlong2YGConfigRef(nativePointer));
+}
+
+jlong jni_YGConfigGetMeasureCacheHitCount(alias_ref<jobject>, jlong nativePointer) {
+  return (jlong) YGConfigGetMeasureCacheStats(_jlong2YGConfigRef(nativePointer)).hits;
+}
+
+jlong jni_YGConfigGetMeasureCacheMissCount(alias_ref<jobject>, jlong nativePointer) {
+  return (jlong) YGConfigGetMeasureCacheStats(_jlong2YGConfigRef(nativePointer)).misses;
+}
+
 void jni_YGConfigSetLogger(alias_ref<jobject>, jlong nativePointer, alias_ref<jobject> logger) {
   const YGConfigRef config = _jlong2YGConfigRef(nativePointer);
 
@@ -453,9 +726,13 @@ jint JNI_OnLoad(JavaVM *vm, void *) {
                         YGMakeNativeMethod(jni_YGNodeInsertChild),
                         YGMakeNativeMethod(jni_YGNodeRemoveChild),
                         YGMakeNativeMethod(jni_YGNodeCalculateLayout),
+                        YGMakeNativeMethod(jni_YGNodeCalculateLayoutPacked),
+                        YGMakeNativeMethod(jni_YGNodePackLayoutOutputs),
+                        YGMakeNativeMethod(jni_YGNodeSerialize),
                         YGMakeNativeMethod(jni_YGNodeMarkDirty),
                         YGMakeNativeMethod(jni_YGNodeIsDirty),
                         YGMakeNativeMethod(jni_YGNodeSetHasMeasureFunc),
+                        YGMakeNativeMethod(jni_YGNodeSetMeasureCacheKey),
                         YGMakeNativeMethod(jni_YGNodeSetHasBaselineFunc),
                         YGMakeNativeMethod(jni_YGNodeCopyStyle),
                         YGMakeNativeMethod(jni_YGNodeStyleGetDirection),
@@ -523,6 +800,10 @@ jint JNI_OnLoad(JavaVM *vm, void *) {
                         YGMakeNativeMethod(jni_YGNodeGetInstanceCount),
                         YGMakeNativeMethod(jni_YGNodePrint),
                     });
+    registerNatives("com/facebook/yoga/YogaStyleBatch",
+                    {
+                        YGMakeNativeMethod(jni_YGNodeApplyStyleBatch),
+                    });
     registerNatives("com/facebook/yoga/YogaConfig",
                     {
                         YGMakeNativeMethod(jni_YGConfigNew),
@@ -531,6 +812,10 @@ jint JNI_OnLoad(JavaVM *vm, void *) {
                         YGMakeNativeMethod(jni_YGConfigSetUseWebDefaults),
                         YGMakeNativeMethod(jni_YGConfigSetPointScaleFactor),
                         YGMakeNativeMethod(jni_YGConfigSetUseLegacyStretchBehaviour),
+                        YGMakeNativeMethod(jni_YGConfigSetMeasureCacheCapacity),
+                        YGMakeNativeMethod(jni_YGConfigClearMeasureCache),
+                        YGMakeNativeMethod(jni_YGConfigGetMeasureCacheHitCount),
+                        YGMakeNativeMethod(jni_YGConfigGetMeasureCacheMissCount),
                         YGMakeNativeMethod(jni_YGConfigSetLogger),
                     });
   });
@@ -16,9 +16,11 @@
 #include <cxxreact/Instance.h>
 #include <cxxreact/JSBundleType.h>
 #include <cxxreact/JSIndexedRAMBundle.h>
+#include <cxxreact/MemoryAccounting.h>
 #include <cxxreact/MethodCall.h>
 #include <cxxreact/ModuleRegistry.h>
 #include <cxxreact/CxxNativeModule.h>
+#include <cxxreact/Tracer.h>
 
 #include "CxxModuleWrapper.h"
 #include "JavaScriptExecutorHolder.h"
@@ -98,6 +100,7 @@ void CatalystInstanceImpl::registerNatives() {
     makeNativeMethod("initializeBridge", CatalystInstanceImpl::initializeBridge),
     makeNativeMethod("jniSetSourceURL", CatalystInstanceImpl::jniSetSourceURL),
     makeNativeMethod("jniLoadScriptFromAssets", CatalystInstanceImpl::jniLoadScriptFromAssets),
+    makeNativeMethod("jniPrefetchScriptFromFile", CatalystInstanceImpl::jniPrefetchScriptFromFile),
     makeNativeMethod("jniLoadScriptFromFile", CatalystInstanceImpl::jniLoadScriptFromFile),
     makeNativeMethod("jniCallJSFunction", CatalystInstanceImpl::jniCallJSFunction),
     makeNativeMethod("jniCallJSCallback", CatalystInstanceImpl::jniCallJSCallback),
@@ -106,9 +109,16 @@ void CatalystInstanceImpl::registerNatives() {
     makeNativeMethod("handleMemoryPressureUiHidden", CatalystInstanceImpl::handleMemoryPressureUiHidden),
     makeNativeMethod("handleMemoryPressureModerate", CatalystInstanceImpl::handleMemoryPressureModerate),
     makeNativeMethod("handleMemoryPressureCritical", CatalystInstanceImpl::handleMemoryPressureCritical),
+    makeNativeMethod("wantsIdleNotifications", CatalystInstanceImpl::wantsIdleNotifications),
+    makeNativeMethod("handleIdle", CatalystInstanceImpl::handleIdle),
+    makeNativeMethod("getMemoryStats", CatalystInstanceImpl::getMemoryStats),
+    makeNativeMethod("setPayloadMemoryStatsEnabled", CatalystInstanceImpl::setPayloadMemoryStatsEnabled),
     makeNativeMethod("supportsProfiling", CatalystInstanceImpl::supportsProfiling),
     makeNativeMethod("startProfiler", CatalystInstanceImpl::startProfiler),
     makeNativeMethod("stopProfiler", CatalystInstanceImpl::stopProfiler),
+    makeNativeMethod("startTracing", CatalystInstanceImpl::startTracing),
+    makeNativeMethod("stopTracing", CatalystInstanceImpl::stopTracing),
+    makeNativeMethod("writeTrace", CatalystInstanceImpl::writeTrace),
   });
 
   JNativeRunnable::registerNatives();
@@ -146,18 +156,24 @@ void CatalystInstanceImpl::initializeBridge(
   // don't need jsModuleDescriptions any more, all the way up and down the
   // stack.
 
+  wantsIdleNotifications_ = jseh->getExecutorFactory()->wantsIdleNotifications();
+
+  // The registry is built on this thread while the JS thread sets up the
+  // executor's context, so the JNI refs captured here stay valid.
   instance_->initializeBridge(
     folly::make_unique<JInstanceCallback>(
     callback,
     uiBackgroundMessageQueue_ != NULL ? uiBackgroundMessageQueue_ : moduleMessageQueue_),
     jseh->getExecutorFactory(),
     folly::make_unique<JMessageQueueThread>(jsQueue),
-    buildModuleRegistry(
-      std::weak_ptr<Instance>(instance_),
-      javaModules,
-      cxxModules,
-      moduleMessageQueue_,
-      uiBackgroundMessageQueue_));
+    [&] {
+      return buildModuleRegistry(
+        std::weak_ptr<Instance>(instance_),
+        javaModules,
+        cxxModules,
+        moduleMessageQueue_,
+        uiBackgroundMessageQueue_);
+    });
 }
 
 void CatalystInstanceImpl::jniSetSourceURL(const std::string& sourceURL) {
@@ -171,6 +187,7 @@ void CatalystInstanceImpl::jniLoadScriptFromAssets(
   auto sourceURL = assetURL.substr(kAssetsLength);
 
   auto manager = extractAssetManager(assetManager);
+  setWorkerAssetManager(manager);
   auto script = loadScriptFromAssets(manager, sourceURL);
   if (JniJSModulesUnbundle::isUnbundle(manager, sourceURL)) {
     instance_->loadUnbundle(
@@ -194,6 +211,13 @@ bool CatalystInstanceImpl::isIndexedRAMBundle(const char *sourcePath) {
   return parseTypeFromHeader(header) == ScriptTag::RAMBundle;
 }
 
+void CatalystInstanceImpl::jniPrefetchScriptFromFile(const std::string& fileName) {
+  // RAM bundles only map the file, and read modules as they are required.
+  if (!isIndexedRAMBundle(fileName.c_str())) {
+    instance_->prefetchScriptFromFile(fileName);
+  }
+}
+
 void CatalystInstanceImpl::jniLoadScriptFromFile(const std::string& fileName,
                                                  const std::string& sourceURL) {
   auto zFileName = fileName.c_str();
@@ -251,6 +275,24 @@ void CatalystInstanceImpl::handleMemoryPressureCritical() {
   instance_->handleMemoryPressureCritical();
 }
 
+jboolean CatalystInstanceImpl::wantsIdleNotifications() {
+  return wantsIdleNotifications_;
+}
+
+void CatalystInstanceImpl::handleIdle(jlong deadlineNanos) {
+  // System.nanoTime() and steady_clock both read CLOCK_MONOTONIC on Android.
+  instance_->handleIdle(std::chrono::steady_clock::time_point(
+    std::chrono::nanoseconds(deadlineNanos)));
+}
+
+jni::local_ref<ReadableNativeMap::jhybridobject> CatalystInstanceImpl::getMemoryStats() {
+  return ReadableNativeMap::createWithContents(instance_->getMemoryStats());
+}
+
+void CatalystInstanceImpl::setPayloadMemoryStatsEnabled(jboolean enabled) {
+  MemoryAccounting::setPayloadSizesEnabled(enabled);
+}
+
 jboolean CatalystInstanceImpl::supportsProfiling() {
   if (!instance_) {
     return false;
@@ -272,4 +314,17 @@ void CatalystInstanceImpl::stopProfiler(const std::string& title, const std::str
   return instance_->stopProfiler(title, filename);
 }
 
+void CatalystInstanceImpl::startTracing(jint eventsPerThread) {
+  Tracer::start(eventsPerThread > 0 ? static_cast<size_t>(eventsPerThread)
+                                    : Tracer::kDefaultEventsPerThread);
+}
+
+void CatalystInstanceImpl::stopTracing() {
+  Tracer::stop();
+}
+
+void CatalystInstanceImpl::writeTrace(const std::string& filename) {
+  Tracer::writeChromeTrace(filename);
+}
+
 }}
@@ -10,6 +10,7 @@
 #include "JMessageQueueThread.h"
 #include "JSLoader.h"
 #include "ModuleRegistryBuilder.h"
+#include "ReadableNativeMap.h"
 
 namespace facebook {
 namespace react {
@@ -58,6 +59,7 @@ class CatalystInstanceImpl : public jni::HybridClass<CatalystInstanceImpl> {
   void jniSetSourceURL(const std::string& sourceURL);
 
   void jniLoadScriptFromAssets(jni::alias_ref<JAssetManager::javaobject> assetManager, const std::string& assetURL);
+  void jniPrefetchScriptFromFile(const std::string& fileName);
   void jniLoadScriptFromFile(const std::string& fileName, const std::string& sourceURL);
   void jniCallJSFunction(std::string module, std::string method, NativeArray* arguments);
   void jniCallJSCallback(jint callbackId, NativeArray* arguments);
@@ -67,15 +69,23 @@ class CatalystInstanceImpl : public jni::HybridClass<CatalystInstanceImpl> {
   void handleMemoryPressureUiHidden();
   void handleMemoryPressureModerate();
   void handleMemoryPressureCritical();
+  jboolean wantsIdleNotifications();
+  void handleIdle(jlong deadlineNanos);
+  jni::local_ref<ReadableNativeMap::jhybridobject> getMemoryStats();
+  void setPayloadMemoryStatsEnabled(jboolean enabled);
   jboolean supportsProfiling();
   void startProfiler(const std::string& title);
   void stopProfiler(const std::string& title, const std::string& filename);
+  void startTracing(jint eventsPerThread);
+  void stopTracing();
+  void writeTrace(const std::string& filename);
 
   // This should be the only long-lived strong reference, but every C++ class
   // will have a weak reference.
   std::shared_ptr<Instance> instance_;
   std::shared_ptr<JMessageQueueThread> moduleMessageQueue_;
   std::shared_ptr<JMessageQueueThread> uiBackgroundMessageQueue_;
+  bool wantsIdleNotifications_ = false;
 };
 
 }}
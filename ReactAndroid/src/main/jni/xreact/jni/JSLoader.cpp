@@ -6,10 +6,9 @@
 #include <folly/Memory.h>
 #include <android/asset_manager_jni.h>
 #include <fb/fbjni.h>
-#include <fstream>
-#include <sstream>
-#include <streambuf>
+#include <atomic>
 #include <string>
+#include <system_error>
 #include <fb/log.h>
 #ifdef WITH_FBSYSTRACE
 #include <fbsystrace.h>
@@ -58,25 +57,34 @@ std::unique_ptr<const JSBigString> loadScriptFromAssets(
     "'. Make sure your bundle is packaged correctly or you're running a packager server."));
 }
 
-std::string loadScriptFromFile(const std::string& fileName) {
+namespace {
+// An application's AssetManager lives as long as the process.
+std::atomic<AAssetManager*> gWorkerAssetManager{nullptr};
+}
+
+void setWorkerAssetManager(AAssetManager *assetManager) {
+  gWorkerAssetManager = assetManager;
+}
+
+std::unique_ptr<const JSBigString> loadWorkerScript(const std::string& url) {
+  static const std::string kAssetsScheme = "assets://";
+  if (url.compare(0, kAssetsScheme.size(), kAssetsScheme) != 0) {
+    return nullptr;
+  }
+  return loadScriptFromAssets(gWorkerAssetManager, url.substr(kAssetsScheme.size()));
+}
+
+std::unique_ptr<const JSBigString> loadScriptFromFile(const std::string& fileName) {
   #ifdef WITH_FBSYSTRACE
   FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_loadScriptFromFile",
     "fileName", fileName);
   #endif
-  std::ifstream jsfile(fileName);
-  if (jsfile) {
-    std::string output;
-    jsfile.seekg(0, std::ios::end);
-    output.reserve(jsfile.tellg());
-    jsfile.seekg(0, std::ios::beg);
-    output.assign(
-      (std::istreambuf_iterator<char>(jsfile)),
-      std::istreambuf_iterator<char>());
-    return output;
+  try {
+    return JSBigFileString::fromPath(fileName, true);
+  } catch (const std::system_error&) {
+    throw std::runtime_error(folly::to<std::string>("Unable to load script from file: '", fileName,
+      "'. Make sure your bundle is packaged correctly or you're running a packager server."));
   }
-
-  throw std::runtime_error(folly::to<std::string>("Unable to load script from file: '", fileName,
-    "'. Make sure your bundle is packaged correctly or you're running a packager server."));
 }
 
 } }
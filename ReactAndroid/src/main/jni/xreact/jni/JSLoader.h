@@ -23,8 +23,17 @@ AAssetManager *extractAssetManager(jni::alias_ref<JAssetManager::javaobject> ass
 std::unique_ptr<const JSBigString> loadScriptFromAssets(AAssetManager *assetManager, const std::string& assetName);
 
 /**
- * Helper method for loading JS script from a file
+ * Loads the scripts of workers started with assets:// URLs, from the asset
+ * manager the application's bundle was last loaded from.  Returns null for
+ * other URLs.
  */
-std::string loadScriptFromFile(const std::string& fileName);
+void setWorkerAssetManager(AAssetManager *assetManager);
+std::unique_ptr<const JSBigString> loadWorkerScript(const std::string& url);
+
+/**
+ * Helper method for loading JS script from a file. The file is mapped rather
+ * than copied onto the heap.
+ */
+std::unique_ptr<const JSBigString> loadScriptFromFile(const std::string& fileName);
 
 } }
@@ -4,6 +4,8 @@
 
 #include <cstdint>
 #include <fb/assert.h>
+#include <folly/Memory.h>
+#include <functional>
 #include <libgen.h>
 #include <memory>
 #include <sstream>
@@ -58,7 +60,7 @@ bool JniJSModulesUnbundle::isUnbundle(
   return fileHeader == htole32(MAGIC_FILE_HEADER);
 }
 
-JSModulesUnbundle::Module JniJSModulesUnbundle::getModule(uint32_t moduleId) const {
+JSModulesUnbundle::ModuleSource JniJSModulesUnbundle::getModuleSource(uint32_t moduleId) const {
   // can be nullptr for default constructor.
   FBASSERTMSGF(m_assetManager != nullptr, "Unbundle has not been initialized with an asset manager");
 
@@ -76,7 +78,14 @@ JSModulesUnbundle::Module JniJSModulesUnbundle::getModule(uint32_t moduleId) con
   if (buffer == nullptr) {
     throw ModuleNotFound("Module not found: " + sourceUrl);
   }
-  return {sourceUrl, std::string(buffer, AAsset_getLength(asset.get()))};
+
+  // JSBigString consumers read up to a nul, which asset buffers do not end
+  // with, so the module is copied into a string that has one. Modules may
+  // hold non-ASCII text, so it is not marked as ASCII.
+  return {
+    sourceUrl,
+    folly::make_unique<JSBigStdString>(std::string(buffer, AAsset_getLength(asset.get())))
+  };
 }
 
 }
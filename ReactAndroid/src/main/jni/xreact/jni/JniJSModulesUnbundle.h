@@ -21,7 +21,7 @@ public:
   static bool isUnbundle(
     AAssetManager *assetManager,
     const std::string& assetName);
-  virtual Module getModule(uint32_t moduleId) const override;
+  virtual ModuleSource getModuleSource(uint32_t moduleId) const override;
 private:
   AAssetManager *m_assetManager = nullptr;
   std::string m_moduleDirectory;
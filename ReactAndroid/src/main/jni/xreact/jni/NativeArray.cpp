@@ -2,6 +2,7 @@
 
 #include "NativeArray.h"
 
+#include <cxxreact/MemoryAccounting.h>
 #include <fb/fbjni.h>
 #include <folly/json.h>
 
@@ -16,6 +17,23 @@ NativeArray::NativeArray(folly::dynamic array)
     throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass,
                                "expected Array, got a %s", array_.typeName());
   }
+  accountedBytes_ = MemoryAccounting::payloadSizesEnabled()
+    ? MemoryAccounting::estimateSize(array_)
+    : 0;
+  MemoryAccounting::allocate(MemoryTag::NativeCollection, accountedBytes_);
+}
+
+NativeArray::~NativeArray() {
+  if (!isConsumed) {
+    MemoryAccounting::release(MemoryTag::NativeCollection, accountedBytes_);
+  }
+}
+
+void NativeArray::accountBytes(size_t bytes) {
+  if (MemoryAccounting::payloadSizesEnabled()) {
+    accountedBytes_ += bytes;
+    MemoryAccounting::grow(MemoryTag::NativeCollection, bytes);
+  }
 }
 
 local_ref<jstring> NativeArray::toString() {
@@ -32,6 +50,7 @@ void NativeArray::registerNatives() {
 folly::dynamic NativeArray::consume() {
   throwIfConsumed();
   isConsumed = true;
+  MemoryAccounting::release(MemoryTag::NativeCollection, accountedBytes_);
   return std::move(array_);
 }
 
@@ -25,8 +25,21 @@ class NativeArray : public jni::HybridClass<NativeArray> {
 
   static void registerNatives();
 
+  ~NativeArray();
+
+  // Bytes charged to MemoryAccounting for the payload, which a collection it
+  // is added to takes over.
+  size_t accountedBytes() const {
+    return accountedBytes_;
+  }
+
  protected:
   folly::dynamic array_;
+  // Bytes reported to MemoryAccounting, until the array is consumed.
+  size_t accountedBytes_;
+
+  // Charges bytes added to the payload, while payload sizes are enabled.
+  void accountBytes(size_t bytes);
 
   friend HybridBase;
   explicit NativeArray(folly::dynamic array);
@@ -2,6 +2,7 @@
 
 #include "NativeMap.h"
 
+#include <cxxreact/MemoryAccounting.h>
 #include <folly/json.h>
 
 using namespace facebook::jni;
@@ -9,6 +10,28 @@ using namespace facebook::jni;
 namespace facebook {
 namespace react {
 
+NativeMap::NativeMap(folly::dynamic s)
+    : isConsumed(false)
+    , map_(s)
+    , accountedBytes_(MemoryAccounting::payloadSizesEnabled()
+                      ? MemoryAccounting::estimateSize(map_)
+                      : 0) {
+  MemoryAccounting::allocate(MemoryTag::NativeCollection, accountedBytes_);
+}
+
+NativeMap::~NativeMap() {
+  if (!isConsumed) {
+    MemoryAccounting::release(MemoryTag::NativeCollection, accountedBytes_);
+  }
+}
+
+void NativeMap::accountBytes(size_t bytes) {
+  if (MemoryAccounting::payloadSizesEnabled()) {
+    accountedBytes_ += bytes;
+    MemoryAccounting::grow(MemoryTag::NativeCollection, bytes);
+  }
+}
+
 std::string NativeMap::toString() {
   throwIfConsumed();
   return ("{ NativeMap: " + folly::toJson(map_) + " }").c_str();
@@ -23,6 +46,7 @@ void NativeMap::registerNatives() {
 folly::dynamic NativeMap::consume() {
   throwIfConsumed();
   isConsumed = true;
+  MemoryAccounting::release(MemoryTag::NativeCollection, accountedBytes_);
   return std::move(map_);
 }
 
@@ -25,12 +25,25 @@ class NativeMap : public jni::HybridClass<NativeMap> {
 
   static void registerNatives();
 
+  ~NativeMap();
+
+  // Bytes charged to MemoryAccounting for the payload, which a collection it
+  // is added to takes over.
+  size_t accountedBytes() const {
+    return accountedBytes_;
+  }
+
  protected:
   folly::dynamic map_;
+  // Bytes reported to MemoryAccounting, until the map is consumed.
+  size_t accountedBytes_;
+
+  // Charges bytes added to the payload, while payload sizes are enabled.
+  void accountBytes(size_t bytes);
 
   friend HybridBase;
   friend struct ReadableNativeMapKeySetIterator;
-  explicit NativeMap(folly::dynamic s) : isConsumed(false), map_(s) {}
+  explicit NativeMap(folly::dynamic s);
 };
 
 }  // namespace react
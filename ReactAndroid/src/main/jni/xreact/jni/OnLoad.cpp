@@ -6,6 +6,7 @@
 #include <fb/log.h>
 #include <cxxreact/Executor.h>
 #include <cxxreact/JSCExecutor.h>
+#include <cxxreact/MessageQueueThread.h>
 #include <cxxreact/Platform.h>
 #include <jschelpers/Value.h>
 #include "CatalystInstanceImpl.h"
@@ -14,6 +15,7 @@
 #include "JSCPerfLogging.h"
 #include "ProxyExecutor.h"
 #include "JCallback.h"
+#include "JSLoader.h"
 #include "JSLogging.h"
 
 #ifdef WITH_INSPECTOR
@@ -24,6 +26,7 @@
 #include "WritableNativeArray.h"
 
 #include <string>
+#include <thread>
 
 using namespace facebook::jni;
 
@@ -32,6 +35,21 @@ namespace react {
 
 namespace {
 
+// Runs each job on a detached thread of its own. Only for jobs that own
+// everything they touch, such as the builds of JSCExecutorFactory's pool.
+class DetachedThreadQueue : public MessageQueueThread {
+ public:
+  void runOnQueue(std::function<void()>&& runnable) override {
+    std::thread(std::move(runnable)).detach();
+  }
+
+  void runOnQueueSync(std::function<void()>&& runnable) override {
+    runnable();
+  }
+
+  void quitSynchronous() override {}
+};
+
 class JSCJavaScriptExecutorHolder : public HybridClass<JSCJavaScriptExecutorHolder,
                                                        JavaScriptExecutorHolder> {
  public:
@@ -40,7 +58,16 @@ class JSCJavaScriptExecutorHolder : public HybridClass<JSCJavaScriptExecutorHold
   static local_ref<jhybriddata> initHybrid(alias_ref<jclass>, ReadableNativeArray* jscConfigArray) {
     // See JSCJavaScriptExecutor.Factory() for the other side of this hack.
     folly::dynamic jscConfigMap = jscConfigArray->consume()[0];
-    return makeCxxInstance(std::make_shared<JSCExecutorFactory>(std::move(jscConfigMap)));
+    int64_t prewarmCount = jscConfigMap.getDefault("PrewarmContexts", 0).asInt();
+    auto factory = std::make_shared<JSCExecutorFactory>(std::move(jscConfigMap));
+    // The Java side builds its native modules before the bridge asks for an
+    // executor, so contexts started here are usually ready by then. Opt-in,
+    // as each context is built on a thread nothing waits for; without it, the
+    // context is still built on the JS queue while the registry is built.
+    if (prewarmCount > 0) {
+      factory->prewarm(std::make_shared<DetachedThreadQueue>(), prewarmCount);
+    }
+    return makeCxxInstance(std::move(factory));
   }
 
   static void registerNatives() {
@@ -85,12 +112,27 @@ class JReactMarker : public JavaClass<JReactMarker> {
  public:
   static constexpr auto kJavaDescriptor = "Lcom/facebook/react/bridge/ReactMarker;";
   static void logMarker(const std::string& marker) {
+    // Some markers are logged from threads the JVM doesn't know about, such as
+    // the one prefetching the bundle.
+    ThreadScope guard;
     static auto cls = javaClassStatic();
     static auto meth = cls->getStaticMethod<void(std::string)>("logMarker");
     meth(cls, marker);
   }
 };
 
+class JWebWorkers : public JavaClass<JWebWorkers> {
+ public:
+  static constexpr auto kJavaDescriptor = "Lcom/facebook/react/bridge/webworkers/WebWorkers;";
+
+  static std::shared_ptr<MessageQueueThread> createWebWorkerThread(int id, MessageQueueThread *ownerMessageQueueThread) {
+    static auto method = javaClassStatic()->
+        getStaticMethod<JavaMessageQueueThread::javaobject(jint, JavaMessageQueueThread::javaobject)>("createWebWorkerThread");
+    auto res = method(javaClassStatic(), id, static_cast<JMessageQueueThread*>(ownerMessageQueueThread)->jobj());
+    return std::make_shared<JMessageQueueThread>(res);
+  }
+};
+
 static JSValueRef nativePerformanceNow(
     JSContextRef ctx,
     JSObjectRef function,
@@ -130,6 +172,24 @@ static void logPerfMarker(const ReactMarker::ReactMarkerId markerId) {
     case ReactMarker::JS_BUNDLE_STRING_CONVERT_STOP:
       JReactMarker::logMarker("loadApplicationScript_endStringConvert");
       break;
+    case ReactMarker::CREATE_MODULE_REGISTRY_START:
+      JReactMarker::logMarker("CREATE_MODULE_REGISTRY_START");
+      break;
+    case ReactMarker::CREATE_MODULE_REGISTRY_STOP:
+      JReactMarker::logMarker("CREATE_MODULE_REGISTRY_END");
+      break;
+    case ReactMarker::CREATE_JS_CONTEXT_START:
+      JReactMarker::logMarker("CREATE_JS_CONTEXT_START");
+      break;
+    case ReactMarker::CREATE_JS_CONTEXT_STOP:
+      JReactMarker::logMarker("CREATE_JS_CONTEXT_END");
+      break;
+    case ReactMarker::LOAD_JS_BUNDLE_START:
+      JReactMarker::logMarker("LOAD_JS_BUNDLE_START");
+      break;
+    case ReactMarker::LOAD_JS_BUNDLE_STOP:
+      JReactMarker::logMarker("LOAD_JS_BUNDLE_END");
+      break;
     case ReactMarker::NATIVE_REQUIRE_START:
     case ReactMarker::NATIVE_REQUIRE_STOP:
       // These are not used on Android.
@@ -147,6 +207,8 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
     PerfLogging::installNativeHooks = addNativePerfLoggingHooks;
     JSNativeHooks::loggingHook = nativeLoggingHook;
     JSNativeHooks::nowHook = nativePerformanceNow;
+    WebWorkerUtil::createWebWorkerThread = JWebWorkers::createWebWorkerThread;
+    WebWorkerUtil::loadScript = loadWorkerScript;
     JSCJavaScriptExecutorHolder::registerNatives();
     ProxyJavaScriptExecutorHolder::registerNatives();
     CatalystInstanceImpl::registerNatives();
@@ -18,21 +18,25 @@ local_ref<WritableNativeArray::jhybriddata> WritableNativeArray::initHybrid(alia
 
 void WritableNativeArray::pushNull() {
   throwIfConsumed();
+  accountBytes(sizeof(folly::dynamic));
   array_.push_back(nullptr);
 }
 
 void WritableNativeArray::pushBoolean(jboolean value) {
   throwIfConsumed();
+  accountBytes(sizeof(folly::dynamic));
   array_.push_back(value == JNI_TRUE);
 }
 
 void WritableNativeArray::pushDouble(jdouble value) {
   throwIfConsumed();
+  accountBytes(sizeof(folly::dynamic));
   array_.push_back(value);
 }
 
 void WritableNativeArray::pushInt(jint value) {
   throwIfConsumed();
+  accountBytes(sizeof(folly::dynamic));
   array_.push_back(value);
 }
 
@@ -42,7 +46,9 @@ void WritableNativeArray::pushString(jstring value) {
     return;
   }
   throwIfConsumed();
-  array_.push_back(wrap_alias(value)->toStdString());
+  auto str = wrap_alias(value)->toStdString();
+  accountBytes(sizeof(folly::dynamic) + str.size());
+  array_.push_back(std::move(str));
 }
 
 void WritableNativeArray::pushNativeArray(WritableNativeArray* otherArray) {
@@ -51,6 +57,7 @@ void WritableNativeArray::pushNativeArray(WritableNativeArray* otherArray) {
     return;
   }
   throwIfConsumed();
+  accountBytes(otherArray->accountedBytes());
   array_.push_back(otherArray->consume());
 }
 
@@ -60,6 +67,7 @@ void WritableNativeArray::pushNativeMap(WritableNativeMap* map) {
     return;
   }
   throwIfConsumed();
+  accountBytes(map->accountedBytes());
   array_.push_back(map->consume());
 }
 
@@ -7,6 +7,16 @@ using namespace facebook::jni;
 namespace facebook {
 namespace react {
 
+namespace {
+
+// Approximates what MemoryAccounting::estimateSize would add for an entry,
+// without walking the value.
+size_t entryBytes(const std::string& key, size_t valueBytes) {
+  return sizeof(folly::dynamic) + key.size() + valueBytes;
+}
+
+}
+
 WritableNativeMap::WritableNativeMap()
   : HybridBase(folly::dynamic::object()) {}
 
@@ -23,21 +33,25 @@ local_ref<WritableNativeMap::jhybriddata> WritableNativeMap::initHybrid(alias_re
 
 void WritableNativeMap::putNull(std::string key) {
   throwIfConsumed();
+  accountBytes(entryBytes(key, sizeof(folly::dynamic)));
   map_.insert(std::move(key), nullptr);
 }
 
 void WritableNativeMap::putBoolean(std::string key, bool val) {
   throwIfConsumed();
+  accountBytes(entryBytes(key, sizeof(folly::dynamic)));
   map_.insert(std::move(key), val);
 }
 
 void WritableNativeMap::putDouble(std::string key, double val) {
   throwIfConsumed();
+  accountBytes(entryBytes(key, sizeof(folly::dynamic)));
   map_.insert(std::move(key), val);
 }
 
 void WritableNativeMap::putInt(std::string key, int val) {
   throwIfConsumed();
+  accountBytes(entryBytes(key, sizeof(folly::dynamic)));
   map_.insert(std::move(key), val);
 }
 
@@ -47,7 +61,9 @@ void WritableNativeMap::putString(std::string key, alias_ref<jstring> val) {
     return;
   }
   throwIfConsumed();
-  map_.insert(std::move(key), val->toString());
+  auto str = val->toString();
+  accountBytes(entryBytes(key, sizeof(folly::dynamic) + str.size()));
+  map_.insert(std::move(key), std::move(str));
 }
 
 void WritableNativeMap::putNativeArray(std::string key, WritableNativeArray* otherArray) {
@@ -56,6 +72,7 @@ void WritableNativeMap::putNativeArray(std::string key, WritableNativeArray* oth
     return;
   }
   throwIfConsumed();
+  accountBytes(entryBytes(key, otherArray->accountedBytes()));
   map_.insert(key, otherArray->consume());
 }
 
@@ -65,6 +82,7 @@ void WritableNativeMap::putNativeMap(std::string key, WritableNativeMap *otherMa
     return;
   }
   throwIfConsumed();
+  accountBytes(entryBytes(key, otherMap->accountedBytes()));
   map_.insert(std::move(key), otherMap->consume());
 }
 
@@ -72,6 +90,7 @@ void WritableNativeMap::mergeNativeMap(ReadableNativeMap* other) {
   throwIfConsumed();
   other->throwIfConsumed();
 
+  accountBytes(other->accountedBytes());
   for (auto sourceIt : other->map_.items()) {
     map_[sourceIt.first] = sourceIt.second;
   }
@@ -8,6 +8,7 @@ LOCAL_SRC_FILES := \
   CxxNativeModule.cpp \
   Instance.cpp \
   JSCExecutor.cpp \
+  JSCIdleCollector.cpp \
   JSBigString.cpp \
   JSBundleType.cpp \
   JSCLegacyProfiler.cpp \
@@ -16,11 +17,16 @@ LOCAL_SRC_FILES := \
   JSCNativeModules.cpp \
   JSCPerfStats.cpp \
   JSCTracing.cpp \
+  JSCWorker.cpp \
   JSIndexedRAMBundle.cpp \
+  JSSegmentedBundle.cpp \
+  MemoryAccounting.cpp \
+  MemoryGovernor.cpp \
   MethodCall.cpp \
   ModuleRegistry.cpp \
   NativeToJsBridge.cpp \
   Platform.cpp \
+  Tracer.cpp \
 	JSCUtils.cpp \
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/..
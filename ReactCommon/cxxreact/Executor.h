@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -46,11 +47,36 @@ class ExecutorDelegate {
     JSExecutor& executor, unsigned int moduleId, unsigned int methodId, folly::dynamic&& args) = 0;
 };
 
+/**
+ * Counters an executor keeps about its own work. They are shared with the
+ * bridge, so they may be read from any thread, even after the executor is
+ * destroyed.
+ */
+class JSExecutorStats {
+public:
+  virtual ~JSExecutorStats() {}
+  virtual folly::dynamic toDynamic() const = 0;
+};
+
 class JSExecutorFactory {
 public:
   virtual std::unique_ptr<JSExecutor> createJSExecutor(
     std::shared_ptr<ExecutorDelegate> delegate,
     std::shared_ptr<MessageQueueThread> jsQueue) = 0;
+  /**
+   * Called before the module registry is built for an executor that will be
+   * created on jsQueue. Factories may post work that does not depend on the
+   * registry to jsQueue here, so that it overlaps with registry construction.
+   */
+  virtual void prepareExecutor(std::shared_ptr<MessageQueueThread> jsQueue) {}
+  /**
+   * Whether the executors this creates make use of handleIdle(). Delivering
+   * idle notifications costs a frame callback each time the bridge goes idle,
+   * so platforms only do so when asked.
+   */
+  virtual bool wantsIdleNotifications() const {
+    return false;
+  }
   virtual ~JSExecutorFactory() {}
 };
 
@@ -97,6 +123,19 @@ public:
   virtual void handleMemoryPressureCritical() {
     handleMemoryPressureModerate();
   }
+  /**
+   * Called on the JS thread when nothing is queued for JS, with the time the
+   * next frame is due. Executors may use the time until then for their own
+   * housekeeping.
+   */
+  virtual void handleIdle(std::chrono::steady_clock::time_point deadline) {}
+  /**
+   * Counters about the executor's own work, or null if it keeps none. Called
+   * once, on the JS thread, right after the executor is created.
+   */
+  virtual std::shared_ptr<const JSExecutorStats> getStats() {
+    return nullptr;
+  }
   virtual void destroy() {}
   virtual ~JSExecutor() {}
 };
@@ -3,7 +3,10 @@
 #include "Instance.h"
 
 #include "Executor.h"
+#include "JSSegmentedBundle.h"
+#include "MemoryAccounting.h"
 #include "MethodCall.h"
+#include "Platform.h"
 #include "RecoverableError.h"
 #include "SystraceSection.h"
 
@@ -14,6 +17,7 @@
 #include <glog/logging.h>
 
 #include <condition_variable>
+#include <future>
 #include <mutex>
 #include <string>
 
@@ -22,6 +26,24 @@ namespace react {
 
 using namespace detail;
 
+namespace {
+
+// Maps the bundle and checks it for non-ASCII bytes, which touches every
+// page, so that the JS thread neither takes the page faults nor scans the
+// bundle before converting it.
+std::unique_ptr<const JSBigString> prefetchScript(
+    std::unique_ptr<const JSBigFileString> script) {
+  SystraceSection s("Instance::prefetchScript");
+  ReactMarker::logMarker(ReactMarker::LOAD_JS_BUNDLE_START);
+
+  script->checkAscii();
+
+  ReactMarker::logMarker(ReactMarker::LOAD_JS_BUNDLE_STOP);
+  return std::move(script);
+}
+
+}
+
 Instance::~Instance() {
   if (nativeToJsBridge_) {
     nativeToJsBridge_->destroy();
@@ -33,8 +55,29 @@ void Instance::initializeBridge(
     std::shared_ptr<JSExecutorFactory> jsef,
     std::shared_ptr<MessageQueueThread> jsQueue,
     std::shared_ptr<ModuleRegistry> moduleRegistry) {
+  initializeBridge(std::move(callback), std::move(jsef), std::move(jsQueue),
+                   [moduleRegistry] { return moduleRegistry; });
+}
+
+void Instance::initializeBridge(
+    std::unique_ptr<InstanceCallback> callback,
+    std::shared_ptr<JSExecutorFactory> jsef,
+    std::shared_ptr<MessageQueueThread> jsQueue,
+    std::function<std::shared_ptr<ModuleRegistry>()> buildModuleRegistry) {
   callback_ = std::move(callback);
 
+  // Anything the factory posts here runs on the JS thread while the registry
+  // is built below, and before the bridge is constructed on the same queue.
+  jsef->prepareExecutor(jsQueue);
+
+  std::shared_ptr<ModuleRegistry> moduleRegistry;
+  {
+    SystraceSection s("Instance::buildModuleRegistry");
+    ReactMarker::logMarker(ReactMarker::CREATE_MODULE_REGISTRY_START);
+    moduleRegistry = buildModuleRegistry();
+    ReactMarker::logMarker(ReactMarker::CREATE_MODULE_REGISTRY_STOP);
+  }
+
   jsQueue->runOnQueueSync(
     [this, &jsef, moduleRegistry, jsQueue] () mutable {
       nativeToJsBridge_ = folly::make_unique<NativeToJsBridge>(
@@ -72,20 +115,64 @@ void Instance::loadScriptFromStringSync(std::unique_ptr<const JSBigString> strin
   nativeToJsBridge_->loadApplicationSync(nullptr, std::move(string), std::move(sourceURL));
 }
 
+void Instance::prefetchScriptFromFile(const std::string& filename) {
+  SystraceSection s("reactbridge_xplat_prefetchScriptFromFile",
+                    "fileName", filename);
+
+  std::unique_ptr<const JSBigFileString> script;
+  try {
+    script = JSBigFileString::fromPath(filename, true);
+  } catch (const std::system_error&) {
+    return;
+  }
+  if (JSSegmentedBundle::isSegmentedBundle(*script)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(prefetchMutex_);
+  prefetchedFilename_ = filename;
+  prefetchedScript_ = std::async(std::launch::async, prefetchScript, std::move(script));
+}
+
 void Instance::loadScriptFromFile(const std::string& filename,
                                   const std::string& sourceURL) {
   callback_->incrementPendingJSCalls();
   SystraceSection s("reactbridge_xplat_loadScriptFromFile",
                     "fileName", filename);
 
+  std::future<std::unique_ptr<const JSBigString>> prefetched;
+  {
+    std::lock_guard<std::mutex> lock(prefetchMutex_);
+    if (prefetchedScript_.valid() && prefetchedFilename_ == filename) {
+      prefetched = std::move(prefetchedScript_);
+    }
+    prefetchedFilename_.clear();
+  }
+  if (prefetched.valid()) {
+    nativeToJsBridge_->loadApplication(nullptr, std::move(prefetched), sourceURL);
+    return;
+  }
+
   std::unique_ptr<const JSBigFileString> script;
 
   RecoverableError::runRethrowingAsRecoverable<std::system_error>(
     [&filename, &script]() {
-      script = JSBigFileString::fromPath(filename);
+      script = JSBigFileString::fromPath(filename, true);
     });
 
-  nativeToJsBridge_->loadApplication(nullptr, std::move(script), sourceURL);
+  // The executor reads segmented bundles one segment at a time, which paging
+  // in the whole file would defeat.
+  if (JSSegmentedBundle::isSegmentedBundle(*script)) {
+    nativeToJsBridge_->loadApplication(nullptr, std::move(script), sourceURL);
+    return;
+  }
+
+  // Opening the file above keeps errors on the caller; the bulk of the I/O
+  // runs on its own thread and overlaps with work already on the JS queue.
+  nativeToJsBridge_->loadApplication(
+    nullptr,
+    std::async(std::launch::async, prefetchScript, std::move(script)),
+    sourceURL);
 }
 
 void Instance::loadUnbundle(std::unique_ptr<JSModulesUnbundle> unbundle,
@@ -151,5 +238,16 @@ void Instance::handleMemoryPressureCritical() {
   nativeToJsBridge_->handleMemoryPressureCritical();
 }
 
+void Instance::handleIdle(std::chrono::steady_clock::time_point deadline) {
+  nativeToJsBridge_->handleIdle(deadline);
+}
+
+folly::dynamic Instance::getMemoryStats() {
+  return folly::dynamic::object
+    ("process", MemoryAccounting::snapshot())
+    ("jsQueue", nativeToJsBridge_->getQueueStats())
+    ("executor", nativeToJsBridge_->getExecutorStats());
+}
+
 } // namespace react
 } // namespace facebook
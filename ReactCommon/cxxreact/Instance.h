@@ -2,7 +2,11 @@
 
 #pragma once
 
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
 
 #include <cxxreact/ModuleRegistry.h>
 #include <cxxreact/NativeModule.h>
@@ -29,11 +33,23 @@ class Instance {
     std::shared_ptr<JSExecutorFactory> jsef,
     std::shared_ptr<MessageQueueThread> jsQueue,
     std::shared_ptr<ModuleRegistry> moduleRegistry);
+  // Builds the module registry on the calling thread while the executor
+  // factory prepares the JS thread, then joins both before returning.
+  void initializeBridge(
+    std::unique_ptr<InstanceCallback> callback,
+    std::shared_ptr<JSExecutorFactory> jsef,
+    std::shared_ptr<MessageQueueThread> jsQueue,
+    std::function<std::shared_ptr<ModuleRegistry>()> buildModuleRegistry);
 
   void setSourceURL(std::string sourceURL);
 
   void loadScriptFromString(std::unique_ptr<const JSBigString> string, std::string sourceURL);
   void loadScriptFromStringSync(std::unique_ptr<const JSBigString> string, std::string sourceURL);
+  // Starts reading filename on a thread of its own, for a later
+  // loadScriptFromFile() of the same file to use. Meant to be called before
+  // initializeBridge(), so that the I/O overlaps building the module registry
+  // and the JS context. Errors are left for loadScriptFromFile() to report.
+  void prefetchScriptFromFile(const std::string& filename);
   void loadScriptFromFile(const std::string& filename, const std::string& sourceURL);
   void loadUnbundle(
     std::unique_ptr<JSModulesUnbundle> unbundle,
@@ -62,11 +78,28 @@ class Instance {
   void handleMemoryPressureModerate();
   void handleMemoryPressureCritical();
 
+  /**
+   * Tells the executor that the bridge is idle and the next frame is due at
+   * deadline. See JSExecutor::handleIdle().
+   */
+  void handleIdle(std::chrono::steady_clock::time_point deadline);
+
+  /**
+   * Breakdown of the native memory held by the bridge:
+   * `{process: {tag: {count, bytes, peakBytes}}, jsQueue: {...},
+   * executor: {...}}`. Process counters are shared by every bridge in the
+   * process. Executor counters include idle collections, if enabled.
+   */
+  folly::dynamic getMemoryStats();
+
  private:
   void callNativeModules(folly::dynamic&& calls, bool isEndOfBatch);
 
   std::shared_ptr<InstanceCallback> callback_;
   std::unique_ptr<NativeToJsBridge> nativeToJsBridge_;
+  std::mutex prefetchMutex_;
+  std::string prefetchedFilename_;
+  std::future<std::unique_ptr<const JSBigString>> prefetchedScript_;
 
   std::mutex m_syncMutex;
   std::condition_variable m_syncCV;
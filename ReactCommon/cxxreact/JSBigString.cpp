@@ -11,7 +11,9 @@
 namespace facebook {
 namespace react {
 
-std::unique_ptr<const JSBigFileString> JSBigFileString::fromPath(const std::string& sourceURL) {
+std::unique_ptr<const JSBigFileString> JSBigFileString::fromPath(
+    const std::string& sourceURL,
+    bool readAhead) {
   int fd = ::open(sourceURL.c_str(), O_RDONLY);
   folly::checkUnixError(fd, "Could not open file", sourceURL);
   SCOPE_EXIT { CHECK(::close(fd) == 0); };
@@ -19,7 +21,30 @@ std::unique_ptr<const JSBigFileString> JSBigFileString::fromPath(const std::stri
   struct stat fileInfo;
   folly::checkUnixError(::fstat(fd, &fileInfo), "fstat on bundle failed.");
 
-  return folly::make_unique<const JSBigFileString>(fd, fileInfo.st_size);
+  return folly::make_unique<const JSBigFileString>(fd, fileInfo.st_size, 0, readAhead);
+}
+
+void JSBigFileString::read(char* buffer, size_t size, size_t offset) const {
+  while (size > 0) {
+    ssize_t count = ::pread(m_fd, buffer, size, m_fileOff + offset);
+    folly::checkUnixError(count, "Could not read from bundle file");
+    if (count == 0) {
+      throw std::system_error(EIO, std::system_category(), "Unexpected end of bundle file");
+    }
+    buffer += count;
+    offset += count;
+    size -= count;
+  }
+}
+
+void JSBigFileString::checkAscii() const {
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(c_str());
+  const size_t length = size();
+  unsigned char bits = 0;
+  for (size_t i = 0; i < length; i++) {
+    bits |= data[i];
+  }
+  m_hasNonAscii = (bits & 0x80) != 0;
 }
 
 }  // namespace react
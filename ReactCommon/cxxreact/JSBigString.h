@@ -5,6 +5,7 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+#include <cxxreact/MemoryAccounting.h>
 #include <folly/Exception.h>
 
 #ifndef RN_EXPORT
@@ -46,7 +47,13 @@ class JSBigStdString : public JSBigString {
 public:
   JSBigStdString(std::string str, bool isAscii=false)
   : m_isAscii(isAscii)
-  , m_str(std::move(str)) {}
+  , m_str(std::move(str)) {
+    MemoryAccounting::allocate(MemoryTag::BigStringBuffer, m_str.capacity());
+  }
+
+  ~JSBigStdString() {
+    MemoryAccounting::release(MemoryTag::BigStringBuffer, m_str.capacity());
+  }
 
   bool isAscii() const override {
     return m_isAscii;
@@ -77,9 +84,11 @@ public:
     // Guarantee nul-termination.  The caller is responsible for
     // filling in the rest of m_data.
     m_data[m_size] = '\0';
+    MemoryAccounting::allocate(MemoryTag::BigStringBuffer, m_size + 1);
   }
 
   ~JSBigBufferString() {
+    MemoryAccounting::release(MemoryTag::BigStringBuffer, m_size + 1);
     delete[] m_data;
   }
 
@@ -108,9 +117,14 @@ private:
 class RN_EXPORT JSBigFileString : public JSBigString {
 public:
 
-  JSBigFileString(int fd, size_t size, off_t offset = 0)
+  // With readAhead, the kernel is told when the file gets mapped that all of
+  // it will be read front to back. Leave it off for files that are only read
+  // in parts, such as RAM bundles.
+  JSBigFileString(int fd, size_t size, off_t offset = 0, bool readAhead = false)
   : m_fd   {-1}
+  , m_fileOff {offset}
   , m_data {nullptr}
+  , m_readAhead {readAhead}
   {
     folly::checkUnixError(
                           m_fd = dup(fd),
@@ -131,14 +145,20 @@ public:
   ~JSBigFileString() {
     if (m_data) {
       munmap((void *)m_data, m_size);
+      MemoryAccounting::release(MemoryTag::BigStringMapping, m_size);
     }
     close(m_fd);
   }
 
+  // File contents are taken to be ASCII unless checkAscii() found otherwise.
   bool isAscii() const override {
-    return true;
+    return !m_hasNonAscii;
   }
 
+  // Scans the contents for non-ASCII bytes, paging all of them in, so that
+  // this can run on a thread other than the one that consumes the string.
+  void checkAscii() const;
+
   const char *c_str() const override {
     if (!m_data) {
       m_data = (const char *)mmap(0, m_size, PROT_READ, MAP_SHARED, m_fd, m_mapOff);
@@ -147,6 +167,13 @@ public:
       << " size: " << m_size
       << " offset: " << m_mapOff
       << " error: " << std::strerror(errno);
+      MemoryAccounting::allocate(MemoryTag::BigStringMapping, m_size);
+
+      // These are only hints, so failures are ignored.
+      if (m_readAhead) {
+        madvise((void *)m_data, m_size, MADV_SEQUENTIAL);
+        madvise((void *)m_data, m_size, MADV_WILLNEED);
+      }
     }
     return m_data + m_pageOff;
   }
@@ -159,14 +186,23 @@ public:
     return m_fd;
   }
 
-  static std::unique_ptr<const JSBigFileString> fromPath(const std::string& sourceURL);
+  // Reads size bytes from offset in the string straight from the file,
+  // without mapping it. Throws std::system_error on failure.
+  void read(char* buffer, size_t size, size_t offset) const;
+
+  static std::unique_ptr<const JSBigFileString> fromPath(
+    const std::string& sourceURL,
+    bool readAhead = false);
 
 private:
   int m_fd;                     // The file descriptor being mmaped
   size_t m_size;                // The size of the mmaped region
   size_t m_pageOff;             // The offset in the mmaped region to the data.
   off_t m_mapOff;               // The offset in the file to the mmaped region.
+  off_t m_fileOff;              // The offset in the file to the data.
   mutable const char *m_data;   // Pointer to the mmaped region.
+  bool m_readAhead;             // Whether to ask for read-ahead when mapping.
+  mutable bool m_hasNonAscii = false;
 };
 
 } }
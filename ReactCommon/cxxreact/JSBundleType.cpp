@@ -8,6 +8,7 @@ namespace react {
 
 static uint32_t constexpr RAMBundleMagicNumber = 0xFB0BD1E5;
 static uint32_t constexpr BCBundleMagicNumber  = 0x6D657300;
+static uint32_t constexpr SegmentedBundleMagicNumber = 0xFB0B5E65;
 
 ScriptTag parseTypeFromHeader(const BundleHeader& header) {
 
@@ -16,6 +17,8 @@ ScriptTag parseTypeFromHeader(const BundleHeader& header) {
     return ScriptTag::RAMBundle;
   case BCBundleMagicNumber:
     return ScriptTag::BCBundle;
+  case SegmentedBundleMagicNumber:
+    return ScriptTag::SegmentedBundle;
   default:
     return ScriptTag::String;
   }
@@ -29,9 +32,15 @@ const char *stringForScriptTag(const ScriptTag& tag) {
       return "RAM Bundle";
     case ScriptTag::BCBundle:
       return "BC Bundle";
+    case ScriptTag::SegmentedBundle:
+      return "Segmented Bundle";
   }
   return "";
 }
 
+uint32_t segmentCountFromHeader(const BundleHeader& header) {
+  return littleEndianToHost(header.reserved_);
+}
+
 }  // namespace react
 }  // namespace facebook
@@ -18,6 +18,7 @@ enum struct ScriptTag {
   String = 0,
   RAMBundle,
   BCBundle,
+  SegmentedBundle,
 };
 
 /**
@@ -37,6 +38,21 @@ struct __attribute__((packed)) BundleHeader {
   uint32_t version;
 };
 
+/**
+ * SegmentTableEntry
+ *
+ * Segmented bundles begin with a BundleHeader whose second word holds the
+ * number of segments. It is followed by one entry per segment, in evaluation
+ * order. Each segment is a script that can be evaluated on its own once the
+ * segments before it have run. Offsets are from the start of the bundle.
+ * Line numbers continue from one segment to the next, so segments should end
+ * with a newline.
+ */
+struct __attribute__((packed)) SegmentTableEntry {
+  uint32_t offset;
+  uint32_t length;
+};
+
 /**
  * parseTypeFromHeader
  *
@@ -53,5 +69,12 @@ ScriptTag parseTypeFromHeader(const BundleHeader& header);
  */
 const char* stringForScriptTag(const ScriptTag& tag);
 
+/**
+ * segmentCountFromHeader
+ *
+ * Returns the number of segments of a segmented bundle, given its header.
+ */
+uint32_t segmentCountFromHeader(const BundleHeader& header);
+
 }  // namespace react
 }  // namespace facebook
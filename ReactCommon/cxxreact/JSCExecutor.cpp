@@ -3,7 +3,9 @@
 #include "JSCExecutor.h"
 
 #include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <exception>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -15,6 +17,7 @@
 #include <fcntl.h>
 #include <sys/time.h>
 #include <system_error>
+#include <thread>
 
 #include <jschelpers/JSCHelpers.h>
 #include <jschelpers/Value.h>
@@ -26,11 +29,15 @@
 #include "JSBundleType.h"
 #include "Platform.h"
 #include "SystraceSection.h"
+#include "JSCIdleCollector.h"
 #include "JSCNativeModules.h"
 #include "JSCSamplingProfiler.h"
 #include "JSCUtils.h"
+#include "JSCWorker.h"
 #include "JSModulesUnbundle.h"
+#include "JSSegmentedBundle.h"
 #include "ModuleRegistry.h"
+#include "oss-compat-util.h"
 #include "RecoverableError.h"
 
 #if defined(WITH_JSC_EXTRA_TRACING) || (DEBUG && defined(WITH_FBSYSTRACE))
@@ -69,6 +76,24 @@ using namespace detail;
 
 namespace {
 
+// Refers only to counters that outlive the executor.
+class JSCExecutorStats : public JSExecutorStats {
+public:
+  explicit JSCExecutorStats(std::shared_ptr<const JSCIdleCollector::Stats> idleCollectorStats)
+    : m_idleCollectorStats(std::move(idleCollectorStats)) {}
+
+  folly::dynamic toDynamic() const override {
+    folly::dynamic stats = folly::dynamic::object();
+    if (m_idleCollectorStats) {
+      stats["idleGC"] = m_idleCollectorStats->toDynamic();
+    }
+    return stats;
+  }
+
+private:
+  std::shared_ptr<const JSCIdleCollector::Stats> m_idleCollectorStats;
+};
+
 template<JSValueRef (JSCExecutor::*method)(size_t, const JSValueRef[])>
 inline JSObjectCallAsFunctionCallback exceptionWrapMethod() {
   struct funcWrapper {
@@ -113,6 +138,110 @@ inline JSObjectGetPropertyCallback exceptionWrapMethod() {
   return &funcWrapper::call;
 }
 
+std::unique_ptr<const JSBigString> loadWorkerScript(const std::string& url) {
+  if (WebWorkerUtil::loadScript) {
+    if (auto script = WebWorkerUtil::loadScript(url)) {
+      return script;
+    }
+  }
+
+  static const std::string kFileScheme = "file://";
+  std::string path = url.compare(0, kFileScheme.size(), kFileScheme) == 0
+    ? url.substr(kFileScheme.size())
+    : url;
+  if (path.empty() || path[0] != '/') {
+    throw std::invalid_argument(
+      folly::to<std::string>("Cannot load a worker script from '", url, "'"));
+  }
+  return JSBigFileString::fromPath(path, true);
+}
+
+// Reads and converts the segments of a segmented bundle on a thread of its
+// own, staying at most one segment ahead of the JS thread that evaluates
+// them. JSStringRefs are not tied to a VM, so they can be created off the JS
+// thread; the context is only used to pick the JSC implementation.
+class SegmentLoader {
+public:
+  struct LoadedSegment {
+    String code;
+    uint32_t startLine;
+  };
+
+  SegmentLoader(JSContextRef ctx, const JSBigString& bundle)
+    : m_context(ctx)
+    , m_bundle(bundle) {
+    m_thread = std::thread([this] { run(); });
+  }
+
+  ~SegmentLoader() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_cancelled = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+  }
+
+  // Blocks until the next segment has been converted. Returns none once every
+  // segment has been handed out, and rethrows anything the loader threw.
+  folly::Optional<LoadedSegment> next() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_ready || m_done; });
+    if (m_error) {
+      std::rethrow_exception(m_error);
+    }
+    if (!m_ready) {
+      return folly::none;
+    }
+    folly::Optional<LoadedSegment> segment(std::move(*m_ready));
+    m_ready.clear();
+    m_cv.notify_all();
+    return segment;
+  }
+
+private:
+  void run() {
+    try {
+      JSSegmentedBundle bundle(m_bundle);
+      while (auto source = bundle.next()) {
+        SystraceSection s("SegmentLoader::loadSegment", "length", source->code->size());
+        LoadedSegment segment {
+          jsStringFromBigString(m_context, *source->code),
+          source->startLine,
+        };
+        source.clear();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return !m_ready || m_cancelled; });
+        if (m_cancelled) {
+          return;
+        }
+        m_ready.emplace(std::move(segment));
+        m_cv.notify_all();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_done = true;
+    m_cv.notify_all();
+  }
+
+  JSContextRef m_context;
+  const JSBigString& m_bundle;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  folly::Optional<LoadedSegment> m_ready;
+  std::exception_ptr m_error;
+  bool m_done = false;
+  bool m_cancelled = false;
+
+  std::thread m_thread;
+};
+
 }
 
 #if DEBUG
@@ -130,25 +259,118 @@ static JSValueRef nativeInjectHMRUpdate(
 }
 #endif
 
+// Contexts built ahead of time for JSCExecutorFactory. Shared with the work
+// posted to the idle queue so that a context finishing after the factory is
+// gone is still released.
+class JSCExecutorFactory::ContextPool {
+public:
+  explicit ContextPool(const folly::dynamic& jscConfig) :
+    m_jscConfig(jscConfig) {}
+
+  ~ContextPool() {
+    for (auto context : m_contexts) {
+      JSC_JSGlobalContextRelease(context);
+    }
+  }
+
+  // Returns the number of contexts the caller should build to bring the pool
+  // up to poolSize, and counts them as queued.
+  size_t reserve(size_t poolSize) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t available = m_contexts.size() + m_queuedCount + m_buildingCount;
+    size_t missing = poolSize > available ? poolSize - available : 0;
+    m_queuedCount += missing;
+    return missing;
+  }
+
+  void build() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queuedCount--;
+      m_buildingCount++;
+    }
+
+    JSGlobalContextRef context = nullptr;
+    try {
+      context = JSCExecutor::createContext(m_jscConfig);
+    } catch (const JSException& e) {
+      LOG(ERROR) << "Failed to prewarm JSC context: " << e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buildingCount--;
+    if (context) {
+      m_contexts.push_back(context);
+    }
+    m_cv.notify_all();
+  }
+
+  // Waits for contexts already being built on other threads, which is never
+  // slower than building one inline. Contexts that are only queued are not
+  // waited for, as they may be queued behind the caller.
+  JSGlobalContextRef take() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_contexts.empty() || m_buildingCount == 0; });
+    if (m_contexts.empty()) {
+      return nullptr;
+    }
+    auto context = m_contexts.back();
+    m_contexts.pop_back();
+    return context;
+  }
+
+private:
+  folly::dynamic m_jscConfig;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<JSGlobalContextRef> m_contexts;
+  size_t m_queuedCount = 0;
+  size_t m_buildingCount = 0;
+};
+
+JSCExecutorFactory::JSCExecutorFactory(const folly::dynamic& jscConfig) :
+    m_jscConfig(jscConfig),
+    m_contextPool(std::make_shared<ContextPool>(jscConfig)) {}
+
 std::unique_ptr<JSExecutor> JSCExecutorFactory::createJSExecutor(
     std::shared_ptr<ExecutorDelegate> delegate, std::shared_ptr<MessageQueueThread> jsQueue) {
-  return folly::make_unique<JSCExecutor>(delegate, jsQueue, m_jscConfig);
+  return folly::make_unique<JSCExecutor>(delegate, jsQueue, m_jscConfig, m_contextPool->take());
+}
+
+void JSCExecutorFactory::prepareExecutor(std::shared_ptr<MessageQueueThread> jsQueue) {
+  // The executor is created on jsQueue right after this work, so the context
+  // built here is the one it adopts.
+  prewarm(std::move(jsQueue), 1);
+}
+
+bool JSCExecutorFactory::wantsIdleNotifications() const {
+  return m_jscConfig.getDefault("IdleGCEnabled", false).getBool();
+}
+
+void JSCExecutorFactory::prewarm(std::shared_ptr<MessageQueueThread> idleQueue, size_t poolSize) {
+  auto pool = m_contextPool;
+  for (size_t missing = pool->reserve(poolSize); missing > 0; missing--) {
+    idleQueue->runOnQueue([pool] {
+      SystraceSection s("JSCExecutorFactory::prewarm");
+      pool->build();
+    });
+  }
 }
 
 JSCExecutor::JSCExecutor(std::shared_ptr<ExecutorDelegate> delegate,
                          std::shared_ptr<MessageQueueThread> messageQueueThread,
                          const folly::dynamic& jscConfig) throw(JSException) :
+    JSCExecutor(delegate, messageQueueThread, jscConfig, nullptr) {}
+
+JSCExecutor::JSCExecutor(std::shared_ptr<ExecutorDelegate> delegate,
+                         std::shared_ptr<MessageQueueThread> messageQueueThread,
+                         const folly::dynamic& jscConfig,
+                         JSGlobalContextRef context) throw(JSException) :
     m_delegate(delegate),
     m_messageQueueThread(messageQueueThread),
     m_nativeModules(delegate ? delegate->getModuleRegistry() : nullptr),
     m_jscConfig(jscConfig) {
-  initOnJSVMThread();
-
-  {
-    SystraceSection s("nativeModuleProxy object");
-    installGlobalProxy(m_context, "nativeModuleProxy",
-                       exceptionWrapMethod<&JSCExecutor::getNativeModule>());
-  }
+  initOnJSVMThread(context);
 }
 
 JSCExecutor::~JSCExecutor() {
@@ -181,20 +403,21 @@ static bool canUseInspector(JSContextRef context) {
 }
 #endif
 
-void JSCExecutor::initOnJSVMThread() throw(JSException) {
-  SystraceSection s("JSCExecutor.initOnJSVMThread");
+JSGlobalContextRef JSCExecutor::createContext(const folly::dynamic& jscConfig) throw(JSException) {
+  SystraceSection s("JSCExecutor::createContext");
+  ReactMarker::logMarker(ReactMarker::CREATE_JS_CONTEXT_START);
 
   #if defined(__APPLE__)
-  const bool useCustomJSC = m_jscConfig.getDefault("UseCustomJSC", false).getBool();
+  const bool useCustomJSC = jscConfig.getDefault("UseCustomJSC", false).getBool();
   if (useCustomJSC) {
-    JSC_configureJSCForIOS(true, toJson(m_jscConfig));
+    JSC_configureJSCForIOS(true, toJson(jscConfig));
   }
   #else
   const bool useCustomJSC = false;
   #endif
 
   #if defined(WITH_FB_JSC_TUNING) && defined(__ANDROID__)
-  configureJSCForAndroid(m_jscConfig);
+  configureJSCForAndroid(jscConfig);
   #endif
 
   // Create a custom global class, so we can store data in it later using JSObjectSetPrivate
@@ -205,42 +428,76 @@ void JSCExecutor::initOnJSVMThread() throw(JSException) {
     definition.attributes |= kJSClassAttributeNoAutomaticPrototype;
     globalClass = JSC_JSClassCreate(useCustomJSC, &definition);
   }
+  JSGlobalContextRef context;
   {
     SystraceSection s("JSGlobalContextCreateInGroup");
-    m_context = JSC_JSGlobalContextCreateInGroup(useCustomJSC, nullptr, globalClass);
+    context = JSC_JSGlobalContextCreateInGroup(useCustomJSC, nullptr, globalClass);
   }
   JSC_JSClassRelease(useCustomJSC, globalClass);
 
-  // Add a pointer to ourselves so we can retrieve it later in our hooks
-  Object::getGlobalObject(m_context).setPrivate(this);
+  installGlobalFunction(context, "nativeFlushQueueImmediate",
+                        exceptionWrapMethod<&JSCExecutor::nativeFlushQueueImmediate>());
+  installGlobalFunction(context, "nativeCallSyncHook",
+                        exceptionWrapMethod<&JSCExecutor::nativeCallSyncHook>());
+  installGlobalFunction(context, "nativeStartWorker",
+                        exceptionWrapMethod<&JSCExecutor::nativeStartWorker>());
+  installGlobalFunction(context, "nativePostMessageToWorker",
+                        exceptionWrapMethod<&JSCExecutor::nativePostMessageToWorker>());
+  installGlobalFunction(context, "nativeTerminateWorker",
+                        exceptionWrapMethod<&JSCExecutor::nativeTerminateWorker>());
 
-#ifdef WITH_INSPECTOR
-  if (canUseInspector(m_context)) {
-    IInspector* pInspector = JSC_JSInspectorGetInstance(true);
-    pInspector->registerGlobalContext("main", m_context);
-  }
-#endif
-
-  installNativeHook<&JSCExecutor::nativeFlushQueueImmediate>("nativeFlushQueueImmediate");
-  installNativeHook<&JSCExecutor::nativeCallSyncHook>("nativeCallSyncHook");
-
-  installGlobalFunction(m_context, "nativeLoggingHook", JSNativeHooks::loggingHook);
-  installGlobalFunction(m_context, "nativePerformanceNow", JSNativeHooks::nowHook);
+  installGlobalFunction(context, "nativeLoggingHook", JSNativeHooks::loggingHook);
+  installGlobalFunction(context, "nativePerformanceNow", JSNativeHooks::nowHook);
 
   #if DEBUG
-  installGlobalFunction(m_context, "nativeInjectHMRUpdate", nativeInjectHMRUpdate);
+  installGlobalFunction(context, "nativeInjectHMRUpdate", nativeInjectHMRUpdate);
   #endif
 
   #if defined(WITH_JSC_EXTRA_TRACING) || (DEBUG && defined(WITH_FBSYSTRACE))
-  addNativeTracingHooks(m_context);
+  addNativeTracingHooks(context);
   #endif
 
   #ifdef WITH_JSC_EXTRA_TRACING
-  addNativeProfilingHooks(m_context);
-  addNativeTracingLegacyHooks(m_context);
+  addNativeProfilingHooks(context);
+  addNativeTracingLegacyHooks(context);
+  #endif
+
+  PerfLogging::installNativeHooks(context);
+
+  #ifdef WITH_FB_MEMORY_PROFILING
+  addNativeMemoryHooks(context);
   #endif
 
-  PerfLogging::installNativeHooks(m_context);
+  #ifdef JSC_HAS_PERF_STATS_API
+  addJSCPerfStatsHooks(context);
+  #endif
+
+  {
+    SystraceSection s("nativeModuleProxy object");
+    installGlobalProxy(context, "nativeModuleProxy",
+                       exceptionWrapMethod<&JSCExecutor::getNativeModule>());
+  }
+
+  ReactMarker::logMarker(ReactMarker::CREATE_JS_CONTEXT_STOP);
+  return context;
+}
+
+void JSCExecutor::initOnJSVMThread(JSGlobalContextRef context) throw(JSException) {
+  SystraceSection s("JSCExecutor.initOnJSVMThread");
+
+  m_context = context ? context : createContext(m_jscConfig);
+
+  // Add a pointer to ourselves so we can retrieve it later in our hooks
+  Object::getGlobalObject(m_context).setPrivate(this);
+
+  // The inspector and the sampling profiler are bound to the thread they are
+  // set up on, so they are only attached once the context reaches the JS thread.
+#ifdef WITH_INSPECTOR
+  if (canUseInspector(m_context)) {
+    IInspector* pInspector = JSC_JSInspectorGetInstance(true);
+    pInspector->registerGlobalContext("main", m_context);
+  }
+#endif
 
   #if defined(__APPLE__) || defined(WITH_JSC_EXTRA_TRACING)
   if (JSC_JSSamplingProfilerEnabled(m_context)) {
@@ -248,18 +505,20 @@ void JSCExecutor::initOnJSVMThread() throw(JSException) {
   }
   #endif
 
-  #ifdef WITH_FB_MEMORY_PROFILING
-  addNativeMemoryHooks(m_context);
-  #endif
-
-  #ifdef JSC_HAS_PERF_STATS_API
-  addJSCPerfStatsHooks(m_context);
-  #endif
+  if (m_jscConfig.getDefault("IdleGCEnabled", false).getBool()) {
+    JSCIdleCollector::Config idleConfig;
+    idleConfig.budget = std::chrono::milliseconds(
+      m_jscConfig.getDefault("IdleGCBudgetMs", idleConfig.budget.count()).asInt());
+    m_idleCollector = folly::make_unique<JSCIdleCollector>(m_context, idleConfig);
+  }
 }
 
 void JSCExecutor::terminateOnJSVMThread() {
+  terminateWorkers();
   m_nativeModules.reset();
 
+  m_idleCollector.reset();
+
 #ifdef WITH_INSPECTOR
   if (canUseInspector(m_context)) {
     IInspector* pInspector = JSC_JSInspectorGetInstance(true);
@@ -299,6 +558,16 @@ void JSCExecutor::loadApplicationScript(std::unique_ptr<const JSBigString> scrip
   ReactMarker::logMarker(ReactMarker::RUN_JS_BUNDLE_START);
   String jsSourceURL(m_context, sourceURL.c_str());
 
+  if (JSSegmentedBundle::isSegmentedBundle(*script)) {
+    evaluateSegmentedBundle(*script, jsSourceURL);
+
+    flush();
+
+    ReactMarker::logMarker(ReactMarker::CREATE_REACT_CONTEXT_STOP);
+    ReactMarker::logMarker(ReactMarker::RUN_JS_BUNDLE_STOP);
+    return;
+  }
+
   // TODO t15069155: reduce the number of overrides here
 #ifdef WITH_FBJSCEXTENSIONS
   if (auto fileStr = dynamic_cast<const JSBigFileString *>(script.get())) {
@@ -369,9 +638,27 @@ void JSCExecutor::loadApplicationScript(std::unique_ptr<const JSBigString> scrip
   ReactMarker::logMarker(ReactMarker::RUN_JS_BUNDLE_STOP);
 }
 
+void JSCExecutor::evaluateSegmentedBundle(const JSBigString& script, const String& jsSourceURL) {
+  SystraceSection s("JSCExecutor::evaluateSegmentedBundle");
+
+  // Segment N is evaluated here while segment N + 1 is read and converted by
+  // the loader, so only a couple of segments are ever held as JS strings.
+  SegmentLoader loader(m_context, script);
+  while (auto segment = loader.next()) {
+    evaluateScript(m_context, segment->code, jsSourceURL, segment->startLine);
+  }
+}
+
 void JSCExecutor::setJSModulesUnbundle(std::unique_ptr<JSModulesUnbundle> unbundle) {
   if (!m_unbundle) {
     installNativeHook<&JSCExecutor::nativeRequire>("nativeRequire");
+    // Modules are required again after being released, at the cost of
+    // reading them from storage, so this only happens under critical
+    // pressure. The governor trims on the JS thread, which owns m_unbundle.
+    m_memoryGovernor.registerCache(
+      "JSModulesUnbundle", MemoryPressure::Critical,
+      [this] { return m_unbundle->residentSize(); },
+      [this] (MemoryPressure) { m_unbundle->releaseMemory(); });
   }
   m_unbundle = std::move(unbundle);
 }
@@ -404,6 +691,9 @@ void JSCExecutor::callNativeModules(Value&& value) {
   // If this fails, you need to pass a fully functional delegate with a
   // module registry to the factory/ctor.
   CHECK(m_delegate) << "Attempting to use native modules without a delegate";
+  if (m_idleCollector) {
+    m_idleCollector->onActivity();
+  }
   try {
     auto calls = value.toJSONString();
     m_delegate->callNativeModules(*this, folly::parseJson(calls), true);
@@ -561,18 +851,32 @@ void JSCExecutor::handleMemoryPressureUiHidden() {
   #ifdef WITH_JSC_MEMORY_PRESSURE
   JSHandleMemoryPressure(this, m_context, JSMemoryPressure::UI_HIDDEN);
   #endif
+  m_memoryGovernor.trim(MemoryPressure::UiHidden);
 }
 
 void JSCExecutor::handleMemoryPressureModerate() {
   #ifdef WITH_JSC_MEMORY_PRESSURE
   JSHandleMemoryPressure(this, m_context, JSMemoryPressure::MODERATE);
   #endif
+  m_memoryGovernor.trim(MemoryPressure::Moderate);
 }
 
 void JSCExecutor::handleMemoryPressureCritical() {
   #ifdef WITH_JSC_MEMORY_PRESSURE
   JSHandleMemoryPressure(this, m_context, JSMemoryPressure::CRITICAL);
   #endif
+  m_memoryGovernor.trim(MemoryPressure::Critical);
+}
+
+void JSCExecutor::handleIdle(std::chrono::steady_clock::time_point deadline) {
+  if (m_idleCollector) {
+    m_idleCollector->collectIfIdle(deadline);
+  }
+}
+
+std::shared_ptr<const JSExecutorStats> JSCExecutor::getStats() {
+  return std::make_shared<JSCExecutorStats>(
+    m_idleCollector ? m_idleCollector->getStats() : nullptr);
 }
 
 void JSCExecutor::flushQueueImmediate(Value&& queue) {
@@ -581,12 +885,39 @@ void JSCExecutor::flushQueueImmediate(Value&& queue) {
 }
 
 void JSCExecutor::loadModule(uint32_t moduleId) {
-  auto module = m_unbundle->getModule(moduleId);
+  auto module = m_unbundle->getModuleSource(moduleId);
   auto sourceUrl = String::createExpectingAscii(m_context, module.name);
-  auto source = String::createExpectingAscii(m_context, module.code);
+  auto source = jsStringFromBigString(m_context, *module.code);
   evaluateScript(m_context, source, sourceUrl);
 }
 
+void JSCExecutor::receiveMessageFromWorker(int workerId, const std::string& message) {
+  SystraceSection s("JSCExecutor::receiveMessageFromWorker");
+  auto it = m_workerObjects.find(workerId);
+  if (it == m_workerObjects.end()) {
+    // The worker was terminated after posting this message.
+    return;
+  }
+
+  auto onmessage = it->second.getProperty("onmessage");
+  if (!onmessage.isObject() || !onmessage.asObject().isFunction()) {
+    return;
+  }
+
+  auto event = Value::fromJSON(
+    m_context, String(m_context, ("{\"data\":" + message + "}").c_str()));
+  onmessage.asObject().callAsFunction(it->second, {event});
+}
+
+void JSCExecutor::terminateWorkers() {
+  for (auto& worker : m_workers) {
+    worker.second->terminate();
+  }
+  m_workers.clear();
+  // These hold protected references, so drop them while the context is alive.
+  m_workerObjects.clear();
+}
+
 // Native JS hooks
 template<JSValueRef (JSCExecutor::*method)(size_t, const JSValueRef[])>
 void JSCExecutor::installNativeHook(const char* name) {
@@ -659,4 +990,76 @@ JSValueRef JSCExecutor::nativeCallSyncHook(
   return Value::fromDynamic(m_context, result.value());
 }
 
+JSValueRef JSCExecutor::nativeStartWorker(
+    size_t argumentCount,
+    const JSValueRef arguments[]) {
+  if (argumentCount != 2) {
+    throw std::invalid_argument("Got wrong number of args");
+  }
+  if (!WebWorkerUtil::createWebWorkerThread || !m_messageQueueThread) {
+    throw std::runtime_error("Workers are not supported by this executor");
+  }
+
+  std::string scriptURL = Value(m_context, arguments[0]).toString().str();
+  Object workerObj = Value(m_context, arguments[1]).asObject();
+  workerObj.makeProtected();
+
+  auto script = loadWorkerScript(scriptURL);
+
+  int workerId = ++m_nextWorkerId;
+  auto worker = folly::make_unique<JSCWorker>(
+    workerId,
+    WebWorkerUtil::createWebWorkerThread(workerId, m_messageQueueThread.get()),
+    [this, workerId, isDestroyed=m_isDestroyed, ownerQueue=m_messageQueueThread]
+        (std::string&& message) {
+      ownerQueue->runOnQueue([this, workerId, isDestroyed, message=std::move(message)] {
+        if (*isDestroyed) {
+          return;
+        }
+        receiveMessageFromWorker(workerId, message);
+      });
+    });
+  worker->loadScript(std::move(script), std::move(scriptURL));
+
+  m_workers.emplace(workerId, std::move(worker));
+  m_workerObjects.emplace(workerId, std::move(workerObj));
+  return Value::makeNumber(m_context, workerId);
+}
+
+JSValueRef JSCExecutor::nativePostMessageToWorker(
+    size_t argumentCount,
+    const JSValueRef arguments[]) {
+  if (argumentCount != 2) {
+    throw std::invalid_argument("Got wrong number of args");
+  }
+
+  int workerId = Value(m_context, arguments[0]).asInteger();
+  auto it = m_workers.find(workerId);
+  if (it == m_workers.end()) {
+    throw std::invalid_argument(folly::to<std::string>("Unknown worker ID: ", workerId));
+  }
+
+  it->second->postMessage(Value(m_context, arguments[1]).toJSONString());
+  return Value::makeUndefined(m_context);
+}
+
+JSValueRef JSCExecutor::nativeTerminateWorker(
+    size_t argumentCount,
+    const JSValueRef arguments[]) {
+  if (argumentCount != 1) {
+    throw std::invalid_argument("Got wrong number of args");
+  }
+
+  int workerId = Value(m_context, arguments[0]).asInteger();
+  auto it = m_workers.find(workerId);
+  if (it == m_workers.end()) {
+    throw std::invalid_argument(folly::to<std::string>("Unknown worker ID: ", workerId));
+  }
+
+  it->second->terminate();
+  m_workers.erase(it);
+  m_workerObjects.erase(workerId);
+  return Value::makeUndefined(m_context);
+}
+
 } }
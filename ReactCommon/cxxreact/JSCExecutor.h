@@ -6,9 +6,12 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include <cxxreact/Executor.h>
+#include <cxxreact/JSCIdleCollector.h>
 #include <cxxreact/JSCNativeModules.h>
+#include <cxxreact/MemoryGovernor.h>
 #include <folly/Optional.h>
 #include <folly/json.h>
 #include <jschelpers/JSCHelpers.h>
@@ -18,18 +21,38 @@
 namespace facebook {
 namespace react {
 
+class JSCWorker;
 class MessageQueueThread;
 
 class RN_EXPORT JSCExecutorFactory : public JSExecutorFactory {
 public:
-  JSCExecutorFactory(const folly::dynamic& jscConfig) :
-    m_jscConfig(jscConfig) {}
+  JSCExecutorFactory(const folly::dynamic& jscConfig);
   std::unique_ptr<JSExecutor> createJSExecutor(
     std::shared_ptr<ExecutorDelegate> delegate,
     std::shared_ptr<MessageQueueThread> jsQueue) override;
+  void prepareExecutor(std::shared_ptr<MessageQueueThread> jsQueue) override;
+  bool wantsIdleNotifications() const override;
+
+  /**
+   * Builds contexts on idleQueue until poolSize of them are ready or being
+   * built. createJSExecutor adopts a pooled context when one is available,
+   * waits for one another thread is building, and falls back to creating one
+   * inline otherwise. Contexts that are never adopted are released once both
+   * the factory and any pending work are gone.
+   *
+   * Meant to be called by whoever creates the factory, as early as possible:
+   * the Android executor holder does so from its own thread. Without it,
+   * prepareExecutor still builds the context on the JS queue while the module
+   * registry is built.
+   */
+  void prewarm(std::shared_ptr<MessageQueueThread> idleQueue, size_t poolSize = 1);
+
 private:
+  class ContextPool;
+
   std::string m_cacheDir;
   folly::dynamic m_jscConfig;
+  std::shared_ptr<ContextPool> m_contextPool;
 };
 
 template <typename T>
@@ -43,8 +66,24 @@ public:
   explicit JSCExecutor(std::shared_ptr<ExecutorDelegate> delegate,
                        std::shared_ptr<MessageQueueThread> messageQueueThread,
                        const folly::dynamic& jscConfig) throw(JSException);
+  /**
+   * Adopts a context built by createContext(), or builds one if context is
+   * null. Must be invoked from thread this Executor will run on.
+   */
+  explicit JSCExecutor(std::shared_ptr<ExecutorDelegate> delegate,
+                       std::shared_ptr<MessageQueueThread> messageQueueThread,
+                       const folly::dynamic& jscConfig,
+                       JSGlobalContextRef context) throw(JSException);
   ~JSCExecutor() override;
 
+  /**
+   * Creates a global context with every hook that does not depend on the
+   * executor or the calling thread installed. Hooks find their executor
+   * through the global object's private data, which is only set when the
+   * context is adopted, so this may run on any thread.
+   */
+  static JSGlobalContextRef createContext(const folly::dynamic& jscConfig) throw(JSException);
+
   virtual void loadApplicationScript(
     std::unique_ptr<const JSBigString> script,
     std::string sourceURL) override;
@@ -83,6 +122,17 @@ public:
   virtual void handleMemoryPressureModerate() override;
   virtual void handleMemoryPressureCritical() override;
 
+  virtual void handleIdle(std::chrono::steady_clock::time_point deadline) override;
+  virtual std::shared_ptr<const JSExecutorStats> getStats() override;
+
+  /**
+   * Native caches that should be trimmed under memory pressure register here.
+   * It is trimmed on the JS thread.
+   */
+  MemoryGovernor& getMemoryGovernor() {
+    return m_memoryGovernor;
+  }
+
   virtual void destroy() override;
 
   void setContextName(const std::string& name);
@@ -94,6 +144,8 @@ private:
   std::shared_ptr<MessageQueueThread> m_messageQueueThread;
   std::unique_ptr<JSModulesUnbundle> m_unbundle;
   JSCNativeModules m_nativeModules;
+  MemoryGovernor m_memoryGovernor;
+  std::unique_ptr<JSCIdleCollector> m_idleCollector;
   folly::dynamic m_jscConfig;
   std::once_flag m_bindFlag;
 
@@ -102,16 +154,23 @@ private:
   folly::Optional<Object> m_flushedQueueJS;
   folly::Optional<Object> m_callFunctionReturnResultAndFlushedQueueJS;
 
-  void initOnJSVMThread() throw(JSException);
+  int m_nextWorkerId = 0;
+  std::unordered_map<int, std::unique_ptr<JSCWorker>> m_workers;
+  std::unordered_map<int, Object> m_workerObjects;
+
+  void initOnJSVMThread(JSGlobalContextRef context) throw(JSException);
   // This method is experimental, and may be modified or removed.
   Value callFunctionSyncWithValue(
     const std::string& module, const std::string& method, Value value);
   void terminateOnJSVMThread();
   void bindBridge() throw(JSException);
   void callNativeModules(Value&&);
+  void evaluateSegmentedBundle(const JSBigString& script, const String& jsSourceURL);
   void flush();
   void flushQueueImmediate(Value&&);
   void loadModule(uint32_t moduleId);
+  void receiveMessageFromWorker(int workerId, const std::string& message);
+  void terminateWorkers();
 
   template<JSValueRef (JSCExecutor::*method)(size_t, const JSValueRef[])>
   void installNativeHook(const char* name);
@@ -126,6 +185,15 @@ private:
   JSValueRef nativeCallSyncHook(
       size_t argumentCount,
       const JSValueRef arguments[]);
+  JSValueRef nativeStartWorker(
+      size_t argumentCount,
+      const JSValueRef arguments[]);
+  JSValueRef nativePostMessageToWorker(
+      size_t argumentCount,
+      const JSValueRef arguments[]);
+  JSValueRef nativeTerminateWorker(
+      size_t argumentCount,
+      const JSValueRef arguments[]);
 };
 
 } }
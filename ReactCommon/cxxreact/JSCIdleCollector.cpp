@@ -0,0 +1,62 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSCIdleCollector.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "SystraceSection.h"
+
+namespace facebook {
+namespace react {
+
+folly::dynamic JSCIdleCollector::Stats::toDynamic() const {
+  return folly::dynamic::object
+    ("collections", static_cast<int64_t>(collections.load()))
+    ("totalPauseUs", static_cast<int64_t>(totalPauseUs.load()))
+    ("lastPauseUs", static_cast<int64_t>(lastPauseUs.load()))
+    ("skippedForDeadline", static_cast<int64_t>(skippedForDeadline.load()))
+    ("skippedForBudget", static_cast<int64_t>(skippedForBudget.load()));
+}
+
+JSCIdleCollector::JSCIdleCollector(JSGlobalContextRef context, Config config)
+  : m_context(context)
+  , m_config(config)
+  , m_expectedPause(config.budget) {}
+
+void JSCIdleCollector::collectIfIdle(Clock::time_point deadline) {
+  if (!m_hasRunJS) {
+    return;
+  }
+
+  if (m_expectedPause > m_config.budget) {
+    // Let the estimate decay, so that a heap that has since shrunk gets
+    // another try.
+    m_expectedPause -= m_expectedPause / 4;
+    m_stats->skippedForBudget++;
+    return;
+  }
+  auto start = Clock::now();
+  if (start + m_expectedPause > deadline) {
+    m_stats->skippedForDeadline++;
+    return;
+  }
+
+  SystraceSection s("JSCIdleCollector::collect");
+  JSC_JSGarbageCollect(m_context);
+  auto pause = Clock::now() - start;
+  m_hasRunJS = false;
+
+  // Follow increases right away and decreases slowly, so that one quick
+  // collection does not let a slow one into a short gap.
+  m_expectedPause = std::max<Clock::duration>(pause, m_expectedPause - m_expectedPause / 4);
+
+  auto pauseUs = std::chrono::duration_cast<std::chrono::microseconds>(pause).count();
+  m_stats->collections++;
+  m_stats->totalPauseUs += pauseUs;
+  m_stats->lastPauseUs = pauseUs;
+  VLOG(1) << "Idle GC took " << pauseUs << "us";
+}
+
+} }
@@ -0,0 +1,82 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <folly/dynamic.h>
+#include <jschelpers/JavaScriptCore.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Runs JSC garbage collections while the JS thread is idle, so that fewer of
+ * them land in the middle of frame-driven work.
+ *
+ * The collector is offered idle time by JSExecutor::handleIdle(), which is
+ * only called once nothing is queued for JS, together with the time the next
+ * frame is due. A collection runs if JS has run since the last one and the
+ * expected pause fits both the budget and the time left before that deadline.
+ * The expected pause follows the pauses measured so far.
+ *
+ * Everything but getStats() must be called on the JS thread.
+ */
+class JSCIdleCollector {
+public:
+  struct Config {
+    // Longest pause an idle collection may cause. Also the pause expected
+    // before the first collection has been measured.
+    std::chrono::milliseconds budget{8};
+  };
+
+  /**
+   * Counters that may be read from any thread while the collector runs.
+   */
+  struct Stats {
+    std::atomic<uint32_t> collections{0};
+    std::atomic<uint64_t> totalPauseUs{0};
+    std::atomic<uint64_t> lastPauseUs{0};
+    // Idle periods that ended too soon for the expected pause.
+    std::atomic<uint32_t> skippedForDeadline{0};
+    // Idle periods skipped because recent collections went over budget.
+    std::atomic<uint32_t> skippedForBudget{0};
+
+    // `{collections, totalPauseUs, lastPauseUs, skippedForDeadline,
+    // skippedForBudget}`
+    folly::dynamic toDynamic() const;
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  JSCIdleCollector(JSGlobalContextRef context, Config config);
+
+  /**
+   * Records that JS just ran, so there may be garbage to collect.
+   */
+  void onActivity() {
+    m_hasRunJS = true;
+  }
+
+  /**
+   * Collects if JS ran since the last collection and the expected pause ends
+   * before deadline.
+   */
+  void collectIfIdle(Clock::time_point deadline);
+
+  std::shared_ptr<const Stats> getStats() const {
+    return m_stats;
+  }
+
+private:
+  JSGlobalContextRef m_context;
+  const Config m_config;
+  std::shared_ptr<Stats> m_stats = std::make_shared<Stats>();
+  bool m_hasRunJS = false;
+  Clock::duration m_expectedPause;
+};
+
+} }
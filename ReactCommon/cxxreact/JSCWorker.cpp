@@ -0,0 +1,184 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSCWorker.h"
+
+#include <atomic>
+
+#include <folly/Conv.h>
+#include <folly/MoveWrapper.h>
+
+#include <jschelpers/JSCHelpers.h>
+#include <jschelpers/Value.h>
+
+#include "JSCUtils.h"
+#include "MessageQueueThread.h"
+#include "Platform.h"
+#include "SystraceSection.h"
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+template<JSValueRef (JSCWorkerContext::*method)(size_t, const JSValueRef[])>
+inline JSObjectCallAsFunctionCallback exceptionWrapMethod() {
+  struct funcWrapper {
+    static JSValueRef call(
+        JSContextRef ctx,
+        JSObjectRef function,
+        JSObjectRef thisObject,
+        size_t argumentCount,
+        const JSValueRef arguments[],
+        JSValueRef *exception) {
+      try {
+        auto context = Object::getGlobalObject(ctx).getPrivate<JSCWorkerContext>();
+        return (context->*method)(argumentCount, arguments);
+      } catch (...) {
+        *exception = translatePendingCppExceptionToJSError(ctx, function);
+        return Value::makeUndefined(ctx);
+      }
+    }
+  };
+
+  return &funcWrapper::call;
+}
+
+}
+
+// The part of a worker that lives on its thread.  Only ever used from there,
+// except for the flag that stops messages to the owner.
+class JSCWorkerContext {
+public:
+  JSCWorkerContext(int id, JSCWorker::MessageHandler postMessageToOwner) :
+      m_id(id),
+      m_postMessageToOwner(std::move(postMessageToOwner)) {}
+
+  void init() {
+    SystraceSection s("JSCWorker::init");
+
+    JSClassRef globalClass = nullptr;
+    {
+      JSClassDefinition definition = kJSClassDefinitionEmpty;
+      definition.attributes |= kJSClassAttributeNoAutomaticPrototype;
+      globalClass = JSC_JSClassCreate(false, &definition);
+    }
+    m_context = JSC_JSGlobalContextCreateInGroup(false, nullptr, globalClass);
+    JSC_JSClassRelease(false, globalClass);
+
+    Object::getGlobalObject(m_context).setPrivate(this);
+
+    installGlobalFunction(m_context, "postMessage",
+                          exceptionWrapMethod<&JSCWorkerContext::nativePostMessage>());
+    installGlobalFunction(m_context, "nativeLoggingHook", JSNativeHooks::loggingHook);
+    installGlobalFunction(m_context, "nativePerformanceNow", JSNativeHooks::nowHook);
+
+    String name(m_context, folly::to<std::string>("worker-", m_id).c_str());
+    JSC_JSGlobalContextSetName(m_context, name);
+  }
+
+  void release() {
+    if (m_context) {
+      Object::getGlobalObject(m_context).setPrivate(nullptr);
+      JSC_JSGlobalContextRelease(m_context);
+      m_context = nullptr;
+    }
+  }
+
+  void loadScript(const JSBigString& script, const std::string& sourceURL) {
+    SystraceSection s("JSCWorker::loadScript", "sourceURL", sourceURL);
+    String jsSourceURL(m_context, sourceURL.c_str());
+    evaluateScript(m_context, jsStringFromBigString(m_context, script), jsSourceURL);
+  }
+
+  void receiveMessage(const std::string& message) {
+    SystraceSection s("JSCWorker::receiveMessage");
+    auto onmessage = Object::getGlobalObject(m_context).getProperty("onmessage");
+    if (!onmessage.isObject() || !onmessage.asObject().isFunction()) {
+      return;
+    }
+
+    // message is already JSON, so wrapping it avoids building the event by hand.
+    auto event = Value::fromJSON(
+      m_context, String(m_context, ("{\"data\":" + message + "}").c_str()));
+    onmessage.asObject().callAsFunction({event});
+  }
+
+  JSValueRef nativePostMessage(
+      size_t argumentCount,
+      const JSValueRef arguments[]) {
+    if (argumentCount != 1) {
+      throw std::invalid_argument("Got wrong number of args");
+    }
+
+    if (!m_isTerminated) {
+      m_postMessageToOwner(Value(m_context, arguments[0]).toJSONString());
+    }
+    return Value::makeUndefined(m_context);
+  }
+
+  void markTerminated() {
+    m_isTerminated = true;
+  }
+
+  // Work already queued behind terminate() is skipped.
+  bool isTerminated() const {
+    return m_isTerminated;
+  }
+
+private:
+  const int m_id;
+  JSCWorker::MessageHandler m_postMessageToOwner;
+  JSGlobalContextRef m_context = nullptr;
+  std::atomic<bool> m_isTerminated{false};
+};
+
+JSCWorker::JSCWorker(int id,
+                     std::shared_ptr<MessageQueueThread> workerQueue,
+                     MessageHandler postMessageToOwner) :
+    m_id(id),
+    m_workerQueue(std::move(workerQueue)),
+    m_context(std::make_shared<JSCWorkerContext>(id, std::move(postMessageToOwner))) {
+  m_workerQueue->runOnQueue([context=m_context] {
+    context->init();
+  });
+}
+
+JSCWorker::~JSCWorker() {
+  terminate();
+}
+
+void JSCWorker::loadScript(std::unique_ptr<const JSBigString> script, std::string sourceURL) {
+  m_workerQueue->runOnQueue(
+      [context=m_context, script=folly::makeMoveWrapper(std::move(script)),
+       sourceURL=std::move(sourceURL)] {
+    if (!context->isTerminated()) {
+      context->loadScript(**script, sourceURL);
+    }
+  });
+}
+
+void JSCWorker::postMessage(std::string message) {
+  m_workerQueue->runOnQueue([context=m_context, message=std::move(message)] {
+    if (!context->isTerminated()) {
+      context->receiveMessage(message);
+    }
+  });
+}
+
+void JSCWorker::terminate() {
+  if (m_isTerminated) {
+    return;
+  }
+  m_isTerminated = true;
+
+  // Whatever the worker is running finishes first; JSC offers no way of
+  // interrupting it.  The queue is quit from its own thread, which doesn't
+  // wait for anything.
+  m_context->markTerminated();
+  m_workerQueue->runOnQueue([context=m_context, queue=m_workerQueue] {
+    context->release();
+    queue->quitSynchronous();
+  });
+}
+
+} }
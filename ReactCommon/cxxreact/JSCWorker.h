@@ -0,0 +1,60 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <cxxreact/JSBigString.h>
+#include <jschelpers/JavaScriptCore.h>
+
+namespace facebook {
+namespace react {
+
+class JSCWorkerContext;
+class MessageQueueThread;
+
+/**
+ * A JS context that runs on its own MessageQueueThread on behalf of a
+ * JSCExecutor.  Each worker gets a context group of its own, so that it does
+ * not contend with the owner for the VM lock.  Worker contexts only have the
+ * logging and timing hooks plus postMessage(); everything exchanged with the
+ * owner is JSON, delivered to the worker's global onmessage as {data}.
+ *
+ * All public methods can be called from any thread, and none of them waits
+ * for the worker, so a busy worker never blocks its owner.
+ */
+class JSCWorker {
+public:
+  using MessageHandler = std::function<void(std::string&& message)>;
+
+  JSCWorker(int id,
+            std::shared_ptr<MessageQueueThread> workerQueue,
+            MessageHandler postMessageToOwner);
+  ~JSCWorker();
+
+  int getId() const {
+    return m_id;
+  }
+
+  void loadScript(std::unique_ptr<const JSBigString> script, std::string sourceURL);
+  void postMessage(std::string message);
+
+  /**
+   * Stops delivering messages to the owner, then releases the worker's
+   * context and stops its queue once the work already queued has run.  The
+   * worker object can be destroyed right away.
+   */
+  void terminate();
+
+private:
+  const int m_id;
+  std::shared_ptr<MessageQueueThread> m_workerQueue;
+  // Everything the worker's thread touches, kept alive by the work posted to
+  // it rather than by this object.
+  std::shared_ptr<JSCWorkerContext> m_context;
+  bool m_isTerminated = false;
+};
+
+} }
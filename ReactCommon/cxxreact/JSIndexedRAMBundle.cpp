@@ -3,15 +3,59 @@
 #include "JSIndexedRAMBundle.h"
 #include "oss-compat-util.h"
 
+#include <folly/Memory.h>
+
 namespace facebook {
 namespace react {
 
-JSIndexedRAMBundle::JSIndexedRAMBundle(const char *sourcePath) :
-    m_bundle (sourcePath, std::ios_base::in) {
-  if (!m_bundle) {
+namespace {
+
+// Module code inside the mapped bundle. Keeps the mapping alive for as long as
+// the module code is referenced.
+class JSBigBundleSlice : public JSBigString {
+public:
+  JSBigBundleSlice(std::shared_ptr<const JSBigString> bundle, size_t offset, size_t size)
+  : m_bundle(std::move(bundle))
+  , m_offset(offset)
+  , m_size(size) {}
+
+  bool isAscii() const override {
+    return true;
+  }
+
+  const char* c_str() const override {
+    return m_bundle->c_str() + m_offset;
+  }
+
+  size_t size() const override {
+    return m_size;
+  }
+
+private:
+  std::shared_ptr<const JSBigString> m_bundle;
+  size_t m_offset;
+  size_t m_size;
+};
+
+// Only a hint, so failures are ignored.
+void adviseRange(const char *data, size_t offset, size_t length, int advice) {
+  if (length == 0) {
+    return;
+  }
+  const uintptr_t pageMask = getpagesize() - 1;
+  const uintptr_t start = reinterpret_cast<uintptr_t>(data + offset) & ~pageMask;
+  const uintptr_t end = reinterpret_cast<uintptr_t>(data + offset + length);
+  madvise(reinterpret_cast<void *>(start), end - start, advice);
+}
+
+}
+
+JSIndexedRAMBundle::JSIndexedRAMBundle(const char *sourcePath) {
+  try {
+    m_mapping = JSBigFileString::fromPath(sourcePath);
+  } catch (const std::system_error& e) {
     throw std::ios_base::failure(
-      toString("Bundle ", sourcePath,
-               "cannot be opened: ", m_bundle.rdstate()));
+      toString("Bundle ", sourcePath, "cannot be opened: ", e.what()));
   }
 
   // read in magic header, number of entries, and length of the startup section
@@ -20,71 +64,95 @@ JSIndexedRAMBundle::JSIndexedRAMBundle(const char *sourcePath) :
     sizeof(header) == 12,
     "header size must exactly match the input file format");
 
-  readBundle(reinterpret_cast<char *>(header), sizeof(header));
+  readBundle(reinterpret_cast<char *>(header), sizeof(header), 0);
   const size_t numTableEntries = littleEndianToHost(header[1]);
   const size_t startupCodeSize = littleEndianToHost(header[2]);
 
   // allocate memory for meta data and lookup table.
+  if (sizeof(header) + uint64_t(numTableEntries) * sizeof(ModuleData) > m_mapping->size()) {
+    throw std::ios_base::failure("Unexpected end of RAM Bundle file");
+  }
   m_table = ModuleTable(numTableEntries);
   m_baseOffset = sizeof(header) + m_table.byteLength();
 
   // read the lookup table from the file
   readBundle(
-    reinterpret_cast<char *>(m_table.data.get()), m_table.byteLength());
-
-  // read the startup code
-  m_startupCode = std::unique_ptr<JSBigBufferString>(new JSBigBufferString{startupCodeSize - 1});
-
-  readBundle(m_startupCode->data(), startupCodeSize - 1);
-}
-
-JSIndexedRAMBundle::Module JSIndexedRAMBundle::getModule(uint32_t moduleId) const {
-  Module ret;
-  ret.name = toString(moduleId, ".js");
-  ret.code = getModuleCode(moduleId);
-  return ret;
-}
+    reinterpret_cast<char *>(m_table.data.get()), m_table.byteLength(), sizeof(header));
 
-std::unique_ptr<const JSBigString> JSIndexedRAMBundle::getStartupCode() {
-  CHECK(m_startupCode) << "startup code for a RAM Bundle can only be retrieved once";
-  return std::move(m_startupCode);
+  // The startup code is served out of the mapping like the modules. Its size
+  // includes a terminating nul.
+  if (startupCodeSize == 0 ||
+      uint64_t(m_baseOffset) + startupCodeSize > m_mapping->size()) {
+    throw std::ios_base::failure("Unexpected end of RAM Bundle file");
+  }
+  if (m_mapping->c_str()[m_baseOffset + startupCodeSize - 1] != '\0') {
+    throw std::ios_base::failure("Startup code in RAM Bundle is not nul-terminated");
+  }
+  m_startupCode = folly::make_unique<JSBigBundleSlice>(
+    m_mapping, m_baseOffset, startupCodeSize - 1);
+  m_servedBytes += startupCodeSize;
+
+  // The startup code is read front to back right away, while modules are
+  // required in no particular order.
+  const size_t modulesOffset = m_baseOffset + startupCodeSize;
+  adviseRange(m_mapping->c_str(), 0, modulesOffset, MADV_WILLNEED);
+  adviseRange(
+    m_mapping->c_str(), modulesOffset, m_mapping->size() - modulesOffset, MADV_RANDOM);
 }
 
-std::string JSIndexedRAMBundle::getModuleCode(const uint32_t id) const {
-  const auto moduleData = id < m_table.numEntries ? &m_table.data[id] : nullptr;
+JSIndexedRAMBundle::ModuleSource JSIndexedRAMBundle::getModuleSource(uint32_t moduleId) const {
+  const auto moduleData = moduleId < m_table.numEntries ? &m_table.data[moduleId] : nullptr;
 
   // entries without associated code have offset = 0 and length = 0
   const uint32_t length = moduleData ? littleEndianToHost(moduleData->length) : 0;
   if (length == 0) {
     throw std::ios_base::failure(
-      toString("Error loading module", id, "from RAM Bundle"));
+      toString("Error loading module", moduleId, "from RAM Bundle"));
   }
 
-  std::string ret(length - 1, '\0');
-  readBundle(&ret.front(), length - 1, m_baseOffset + littleEndianToHost(moduleData->offset));
+  const size_t offset = m_baseOffset + littleEndianToHost(moduleData->offset);
+  if (uint64_t(offset) + length > m_mapping->size()) {
+    throw std::ios_base::failure("Unexpected end of RAM Bundle file");
+  }
+  // the stored length includes a terminating nul, which lets the engine use
+  // the mapped code directly.
+  if (m_mapping->c_str()[offset + length - 1] != '\0') {
+    throw std::ios_base::failure(
+      toString("Module ", moduleId, " in RAM Bundle is not nul-terminated"));
+  }
+
+  m_servedBytes += length;
+
+  ModuleSource ret;
+  ret.name = toString(moduleId, ".js");
+  ret.code = folly::make_unique<JSBigBundleSlice>(m_mapping, offset, length - 1);
   return ret;
 }
 
-void JSIndexedRAMBundle::readBundle(char *buffer, const std::streamsize bytes) const {
-  if (!m_bundle.read(buffer, bytes)) {
-    if (m_bundle.rdstate() & std::ios::eofbit) {
-      throw std::ios_base::failure("Unexpected end of RAM Bundle file");
-    }
-    throw std::ios_base::failure(
-      toString("Error reading RAM Bundle: ", m_bundle.rdstate()));
-  }
+size_t JSIndexedRAMBundle::residentSize() const {
+  return m_servedBytes;
+}
+
+void JSIndexedRAMBundle::releaseMemory() {
+  // The mapping is read-only and backed by the file, so slices handed out
+  // earlier fault their pages back in.
+  adviseRange(m_mapping->c_str(), 0, m_mapping->size(), MADV_DONTNEED);
+  m_servedBytes = 0;
+}
+
+std::unique_ptr<const JSBigString> JSIndexedRAMBundle::getStartupCode() {
+  CHECK(m_startupCode) << "startup code for a RAM Bundle can only be retrieved once";
+  return std::move(m_startupCode);
 }
 
 void JSIndexedRAMBundle::readBundle(
     char *buffer,
-    const std::streamsize bytes,
-    const std::ifstream::pos_type position) const {
-
-  if (!m_bundle.seekg(position)) {
-    throw std::ios_base::failure(
-      toString("Error reading RAM Bundle: ", m_bundle.rdstate()));
+    const size_t bytes,
+    const size_t position) const {
+  if (uint64_t(position) + bytes > m_mapping->size()) {
+    throw std::ios_base::failure("Unexpected end of RAM Bundle file");
   }
-  readBundle(buffer, bytes);
+  memcpy(buffer, m_mapping->c_str() + position, bytes);
 }
 
 }  // namespace react
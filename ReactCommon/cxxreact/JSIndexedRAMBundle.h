@@ -2,7 +2,7 @@
 
 #pragma once
 
-#include <fstream>
+#include <atomic>
 #include <memory>
 
 #include <cxxreact/Executor.h>
@@ -22,7 +22,13 @@ public:
   // Throws std::runtime_error on failure.
   std::unique_ptr<const JSBigString> getStartupCode();
   // Throws std::runtime_error on failure.
-  Module getModule(uint32_t moduleId) const override;
+  ModuleSource getModuleSource(uint32_t moduleId) const override;
+
+  // Counts the code served since the bundle was mapped or last released. Pages
+  // of the mapping shared by several modules are counted for each of them.
+  size_t residentSize() const override;
+  // Drops the mapped pages. They are read from the file again when touched.
+  void releaseMemory() override;
 
 private:
   struct ModuleData {
@@ -45,17 +51,13 @@ private:
     }
   };
 
-  std::string getModuleCode(const uint32_t id) const;
-  void readBundle(char *buffer, const std::streamsize bytes) const;
-  void readBundle(
-    char *buffer, const
-    std::streamsize bytes,
-    const std::ifstream::pos_type position) const;
+  void readBundle(char *buffer, const size_t bytes, const size_t position) const;
 
-  mutable std::ifstream m_bundle;
+  std::shared_ptr<const JSBigFileString> m_mapping;
   ModuleTable m_table;
   size_t m_baseOffset;
-  std::unique_ptr<JSBigBufferString> m_startupCode;
+  std::unique_ptr<const JSBigString> m_startupCode;
+  mutable std::atomic<size_t> m_servedBytes{0};
 };
 
 }  // namespace react
@@ -3,9 +3,11 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <stdexcept>
 
+#include <cxxreact/JSBigString.h>
 #include <jschelpers/noncopyable.h>
 
 namespace facebook {
@@ -27,8 +29,39 @@ public:
     std::string name;
     std::string code;
   };
+  /**
+   * Module code as a view onto whatever storage holds it, e.g. a mapped
+   * bundle. The storage stays alive for as long as `code` does, which lets
+   * the code reach the engine without being copied onto the heap.
+   */
+  struct ModuleSource {
+    std::string name;
+    std::unique_ptr<const JSBigString> code;
+  };
   virtual ~JSModulesUnbundle() {}
-  virtual Module getModule(uint32_t moduleId) const = 0;
+
+  /**
+   * Implementations provide getModuleSource. getModule is an adapter around
+   * it for callers that want the code as a std::string.
+   */
+  virtual Module getModule(uint32_t moduleId) const {
+    auto source = getModuleSource(moduleId);
+    return {
+      std::move(source.name),
+      std::string(source.code->c_str(), source.code->size()),
+    };
+  }
+  virtual ModuleSource getModuleSource(uint32_t moduleId) const = 0;
+
+  /**
+   * Bytes of module code the unbundle holds in memory on its own account.
+   * releaseMemory() gives them back, e.g. under memory pressure, after which
+   * module code handed out earlier must still be readable.
+   */
+  virtual size_t residentSize() const {
+    return 0;
+  }
+  virtual void releaseMemory() {}
 };
 
 }
@@ -0,0 +1,85 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSSegmentedBundle.h"
+#include "oss-compat-util.h"
+
+#include <algorithm>
+
+#include <folly/Memory.h>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+void readBundle(const JSBigString& bundle, char* buffer, size_t size, size_t offset) {
+  if (uint64_t(offset) + size > bundle.size()) {
+    throw std::runtime_error("Unexpected end of segmented bundle");
+  }
+  if (auto file = dynamic_cast<const JSBigFileString*>(&bundle)) {
+    file->read(buffer, size, offset);
+  } else {
+    memcpy(buffer, bundle.c_str() + offset, size);
+  }
+}
+
+}
+
+bool JSSegmentedBundle::isSegmentedBundle(const JSBigString& bundle) {
+  if (bundle.size() < sizeof(BundleHeader)) {
+    return false;
+  }
+  BundleHeader header;
+  readBundle(bundle, reinterpret_cast<char*>(&header), sizeof(header), 0);
+  return parseTypeFromHeader(header) == ScriptTag::SegmentedBundle;
+}
+
+JSSegmentedBundle::JSSegmentedBundle(const JSBigString& bundle) :
+    m_bundle(bundle) {
+  if (bundle.size() < sizeof(BundleHeader)) {
+    throw std::runtime_error("Segmented bundle is too small for its header");
+  }
+  BundleHeader header;
+  readBundle(bundle, reinterpret_cast<char*>(&header), sizeof(header), 0);
+
+  uint64_t segmentCount = segmentCountFromHeader(header);
+  uint64_t tableEnd = sizeof(BundleHeader) + segmentCount * sizeof(SegmentTableEntry);
+  if (tableEnd > bundle.size()) {
+    throw std::runtime_error("Segmented bundle is too small for its segment table");
+  }
+
+  m_segments.resize(segmentCount);
+  readBundle(
+    bundle,
+    reinterpret_cast<char*>(m_segments.data()),
+    segmentCount * sizeof(SegmentTableEntry),
+    sizeof(BundleHeader));
+  for (auto& segment : m_segments) {
+    segment.offset = littleEndianToHost(segment.offset);
+    segment.length = littleEndianToHost(segment.length);
+    if (uint64_t(segment.offset) + segment.length > bundle.size()) {
+      throw std::runtime_error("Segment lies outside of the segmented bundle");
+    }
+  }
+}
+
+folly::Optional<JSSegmentedBundle::Segment> JSSegmentedBundle::next() {
+  if (m_nextSegment == m_segments.size()) {
+    return folly::none;
+  }
+  const auto& entry = m_segments[m_nextSegment++];
+
+  // Copying out of the bundle gives each segment its terminating nul and lets
+  // it be released as soon as it has been converted.
+  auto code = folly::make_unique<JSBigBufferString>(entry.length);
+  readBundle(m_bundle, code->data(), entry.length, entry.offset);
+
+  Segment segment;
+  segment.startLine = m_nextLine;
+  m_nextLine += std::count(code->data(), code->data() + entry.length, '\n');
+  segment.code = std::move(code);
+  return std::move(segment);
+}
+
+}  // namespace react
+}  // namespace facebook
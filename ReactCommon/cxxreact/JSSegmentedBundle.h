@@ -0,0 +1,58 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <cxxreact/JSBigString.h>
+#include <cxxreact/JSBundleType.h>
+#include <folly/Optional.h>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace facebook {
+namespace react {
+
+/**
+ * Reads the segments of a segmented bundle, see SegmentTableEntry, one at a
+ * time. Segments of a bundle held in a JSBigFileString are read from its file
+ * without mapping the rest of it, so only the segments being read need to be
+ * in memory.
+ *
+ * The bundle must outlive the reader.
+ */
+class RN_EXPORT JSSegmentedBundle {
+public:
+  struct Segment {
+    std::unique_ptr<const JSBigString> code;
+    // One-based line of the segment's first line, counting the lines of the
+    // segments before it, so that one source map of all the segments
+    // concatenated in order covers each of them.
+    uint32_t startLine;
+  };
+
+  static bool isSegmentedBundle(const JSBigString& bundle);
+
+  // Throws std::runtime_error if the segment table is malformed.
+  explicit JSSegmentedBundle(const JSBigString& bundle);
+
+  size_t segmentCount() const {
+    return m_segments.size();
+  }
+
+  // Reads the next segment in evaluation order, or returns none once all of
+  // them have been read. Throws std::runtime_error on failure.
+  folly::Optional<Segment> next();
+
+private:
+  const JSBigString& m_bundle;
+  std::vector<SegmentTableEntry> m_segments;
+  size_t m_nextSegment = 0;
+  uint32_t m_nextLine = 1;
+};
+
+}  // namespace react
+}  // namespace facebook
@@ -0,0 +1,101 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "MemoryAccounting.h"
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+struct Counter {
+  Watermark count;
+  Watermark bytes;
+};
+
+Counter& counterFor(MemoryTag tag) {
+  static Counter counters[static_cast<size_t>(MemoryTag::Count)];
+  return counters[static_cast<size_t>(tag)];
+}
+
+std::atomic<bool> gPayloadSizesEnabled{false};
+
+}
+
+void MemoryAccounting::allocate(MemoryTag tag, size_t bytes) {
+  auto& counter = counterFor(tag);
+  counter.count.add(1);
+  counter.bytes.add(bytes);
+}
+
+void MemoryAccounting::grow(MemoryTag tag, size_t bytes) {
+  counterFor(tag).bytes.add(bytes);
+}
+
+void MemoryAccounting::release(MemoryTag tag, size_t bytes) {
+  auto& counter = counterFor(tag);
+  counter.count.subtract(1);
+  counter.bytes.subtract(bytes);
+}
+
+void MemoryAccounting::setPayloadSizesEnabled(bool enabled) {
+  gPayloadSizesEnabled = enabled;
+}
+
+bool MemoryAccounting::payloadSizesEnabled() {
+  return gPayloadSizesEnabled.load(std::memory_order_relaxed);
+}
+
+folly::dynamic MemoryAccounting::snapshot() {
+  folly::dynamic stats = folly::dynamic::object();
+  for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++) {
+    auto tag = static_cast<MemoryTag>(i);
+    auto& counter = counterFor(tag);
+    stats[stringForMemoryTag(tag)] = folly::dynamic::object
+      ("count", static_cast<int64_t>(counter.count.current()))
+      ("bytes", static_cast<int64_t>(counter.bytes.current()))
+      ("peakBytes", static_cast<int64_t>(counter.bytes.peak()));
+  }
+  return stats;
+}
+
+size_t MemoryAccounting::estimateSize(const folly::dynamic& value) {
+  size_t bytes = sizeof(folly::dynamic);
+  switch (value.type()) {
+    case folly::dynamic::STRING:
+      bytes += value.getString().capacity();
+      break;
+    case folly::dynamic::ARRAY:
+      for (const auto& element : value) {
+        bytes += estimateSize(element);
+      }
+      break;
+    case folly::dynamic::OBJECT:
+      for (const auto& item : value.items()) {
+        bytes += estimateSize(item.first) + estimateSize(item.second);
+      }
+      break;
+    default:
+      break;
+  }
+  return bytes;
+}
+
+const char* stringForMemoryTag(MemoryTag tag) {
+  switch (tag) {
+    case MemoryTag::BigStringBuffer:
+      return "bigStringBuffers";
+    case MemoryTag::BigStringMapping:
+      return "bigStringMappings";
+    case MemoryTag::NativeCollection:
+      return "nativeCollections";
+    case MemoryTag::QueuedCall:
+      return "queuedCalls";
+    case MemoryTag::Count:
+      break;
+  }
+  return "";
+}
+
+} }
@@ -0,0 +1,95 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace folly {
+struct dynamic;
+}
+
+namespace facebook {
+namespace react {
+
+/**
+ * A quantity that goes up and down, together with the highest value it has
+ * reached. Safe to use from any thread.
+ */
+class Watermark {
+public:
+  void add(size_t amount) {
+    size_t current = m_current.fetch_add(amount) + amount;
+    size_t peak = m_peak.load();
+    while (current > peak && !m_peak.compare_exchange_weak(peak, current)) {}
+  }
+
+  void subtract(size_t amount) {
+    m_current.fetch_sub(amount);
+  }
+
+  size_t current() const {
+    return m_current.load();
+  }
+
+  size_t peak() const {
+    return m_peak.load();
+  }
+
+private:
+  std::atomic<size_t> m_current{0};
+  std::atomic<size_t> m_peak{0};
+};
+
+enum class MemoryTag {
+  // Heap buffers owned by JSBigBufferString and JSBigStdString.
+  BigStringBuffer = 0,
+  // Regions of bundles mapped by JSBigFileString.
+  BigStringMapping,
+  // Payloads of NativeArray and NativeMap hybrids, measured as they are
+  // filled, while payload sizes are enabled.
+  NativeCollection,
+  // Arguments of calls waiting on a JS queue, while payload sizes are
+  // enabled.
+  QueuedCall,
+  Count,
+};
+
+/**
+ * Process-wide byte counters for the structures the bridge allocates the
+ * most memory for. Each tag keeps the number of live allocations, their
+ * total size and its high watermark.
+ */
+class RN_EXPORT MemoryAccounting {
+public:
+  static void allocate(MemoryTag tag, size_t bytes);
+  // Adds bytes to an allocation counted by allocate().
+  static void grow(MemoryTag tag, size_t bytes);
+  static void release(MemoryTag tag, size_t bytes);
+
+  /**
+   * Measuring call arguments and collection payloads costs time on every
+   * bridge call, so it is off until enabled. Each allocation releases what it
+   * was charged, so this can be toggled at any time.
+   */
+  static void setPayloadSizesEnabled(bool enabled);
+  static bool payloadSizesEnabled();
+
+  /**
+   * Returns `{tag: {count, bytes, peakBytes}}` for every tag.
+   */
+  static folly::dynamic snapshot();
+
+  /**
+   * Approximate size of a dynamic and everything it holds, in bytes.
+   */
+  static size_t estimateSize(const folly::dynamic& value);
+};
+
+const char* stringForMemoryTag(MemoryTag tag);
+
+} }
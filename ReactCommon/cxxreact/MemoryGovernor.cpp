@@ -0,0 +1,90 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "MemoryGovernor.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+#include "SystraceSection.h"
+
+namespace facebook {
+namespace react {
+
+int MemoryGovernor::registerCache(
+    std::string name,
+    MemoryPressure minimumLevel,
+    SizeCallback size,
+    TrimCallback trim) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  int id = m_nextId++;
+  m_caches.push_back({id, std::move(name), minimumLevel, std::move(size), std::move(trim)});
+  return id;
+}
+
+void MemoryGovernor::unregisterCache(int id) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_caches.erase(
+    std::remove_if(m_caches.begin(), m_caches.end(),
+                   [id] (const Cache& cache) { return cache.id == id; }),
+    m_caches.end());
+}
+
+size_t MemoryGovernor::size() const {
+  std::vector<Cache> caches;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    caches = m_caches;
+  }
+
+  size_t total = 0;
+  for (const auto& cache : caches) {
+    total += cache.size();
+  }
+  return total;
+}
+
+size_t MemoryGovernor::trim(MemoryPressure level) {
+  SystraceSection s("MemoryGovernor::trim", "level", stringForMemoryPressure(level));
+
+  // Callbacks run without the lock held, so that a cache may unregister
+  // itself or others while being trimmed.
+  std::vector<Cache> caches;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    caches = m_caches;
+  }
+
+  size_t released = 0;
+  for (const auto& cache : caches) {
+    if (cache.minimumLevel > level) {
+      continue;
+    }
+
+    size_t before = cache.size();
+    cache.trim(level);
+    size_t after = cache.size();
+    if (after < before) {
+      released += before - after;
+      VLOG(2) << "Trimmed " << (before - after) << " bytes from " << cache.name;
+    }
+  }
+
+  VLOG(1) << "Memory pressure " << stringForMemoryPressure(level)
+            << ": released " << released << " bytes of native caches";
+  return released;
+}
+
+const char* stringForMemoryPressure(MemoryPressure level) {
+  switch (level) {
+    case MemoryPressure::UiHidden:
+      return "UiHidden";
+    case MemoryPressure::Moderate:
+      return "Moderate";
+    case MemoryPressure::Critical:
+      return "Critical";
+  }
+  return "";
+}
+
+} }
@@ -0,0 +1,78 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <jschelpers/noncopyable.h>
+
+namespace facebook {
+namespace react {
+
+enum class MemoryPressure {
+  UiHidden = 0,
+  Moderate,
+  Critical,
+};
+
+/**
+ * Trims native caches when the system asks us to release memory. This is
+ * independent of the engine: it runs whether or not JSC knows how to handle
+ * memory pressure itself.
+ *
+ * Caches register how to measure themselves and how to trim themselves, and
+ * the lowest pressure level at which they should be trimmed. Higher levels
+ * trim every cache that lower levels do, and more.
+ */
+class MemoryGovernor : noncopyable {
+public:
+  // Bytes currently held by a cache.
+  using SizeCallback = std::function<size_t()>;
+  // Releases what the cache is willing to give up at the given level.
+  using TrimCallback = std::function<void(MemoryPressure)>;
+
+  MemoryGovernor() = default;
+
+  /**
+   * Returns an id that can be passed to unregisterCache(). Callbacks are only
+   * ever invoked from trim() and size(), on the thread calling them.
+   */
+  int registerCache(
+    std::string name,
+    MemoryPressure minimumLevel,
+    SizeCallback size,
+    TrimCallback trim);
+  void unregisterCache(int id);
+
+  /**
+   * Total size of all registered caches, in bytes.
+   */
+  size_t size() const;
+
+  /**
+   * Trims every cache registered for `level` or below, and returns the number
+   * of bytes released.
+   */
+  size_t trim(MemoryPressure level);
+
+private:
+  struct Cache {
+    int id;
+    std::string name;
+    MemoryPressure minimumLevel;
+    SizeCallback size;
+    TrimCallback trim;
+  };
+
+  mutable std::mutex m_mutex;
+  std::vector<Cache> m_caches;
+  int m_nextId = 0;
+};
+
+const char* stringForMemoryPressure(MemoryPressure level);
+
+} }
@@ -2,11 +2,7 @@
 
 #include "NativeToJsBridge.h"
 
-#ifdef WITH_FBSYSTRACE
-#include <fbsystrace.h>
-using fbsystrace::FbSystraceAsyncFlow;
-#endif
-
+#include <folly/Conv.h>
 #include <folly/json.h>
 #include <folly/Memory.h>
 #include <folly/MoveWrapper.h>
@@ -80,7 +76,9 @@ NativeToJsBridge::NativeToJsBridge(
     : m_destroyed(std::make_shared<bool>(false))
     , m_delegate(std::make_shared<JsToNativeBridge>(registry, callback))
     , m_executor(jsExecutorFactory->createJSExecutor(m_delegate, jsQueue))
-    , m_executorMessageQueueThread(std::move(jsQueue)) {}
+    , m_executorStats(m_executor->getStats())
+    , m_executorMessageQueueThread(std::move(jsQueue))
+    , m_queueStats(std::make_shared<QueueStats>()) {}
 
 // This must be called on the same thread on which the constructor was called.
 NativeToJsBridge::~NativeToJsBridge() {
@@ -106,6 +104,29 @@ void NativeToJsBridge::loadApplication(
   });
 }
 
+void NativeToJsBridge::loadApplication(
+    std::unique_ptr<JSModulesUnbundle> unbundle,
+    std::future<std::unique_ptr<const JSBigString>> startupScript,
+    std::string startupScriptSourceURL) {
+  runOnExecutorQueue(
+      [unbundleWrap=folly::makeMoveWrapper(std::move(unbundle)),
+       startupScript=folly::makeMoveWrapper(std::move(startupScript)),
+       startupScriptSourceURL=std::move(startupScriptSourceURL)]
+        (JSExecutor* executor) mutable {
+    auto unbundle = unbundleWrap.move();
+    if (unbundle) {
+      executor->setJSModulesUnbundle(std::move(unbundle));
+    }
+    std::unique_ptr<const JSBigString> script;
+    {
+      SystraceSection s("NativeToJsBridge::loadApplication wait for script");
+      script = startupScript->get();
+    }
+    executor->loadApplicationScript(std::move(script),
+                                    std::move(startupScriptSourceURL));
+  });
+}
+
 void NativeToJsBridge::loadApplicationSync(
     std::unique_ptr<JSModulesUnbundle> unbundle,
     std::unique_ptr<const JSBigString> startupScript,
@@ -122,58 +143,52 @@ void NativeToJsBridge::callFunction(
     std::string&& method,
     folly::dynamic&& arguments) {
   int systraceCookie = -1;
-  #ifdef WITH_FBSYSTRACE
-  systraceCookie = m_systraceCookie++;
-  std::string tracingName = fbsystrace_is_tracing(TRACE_TAG_REACT_CXX_BRIDGE) ?
-    folly::to<std::string>("JSCall__", module, '_', method) : std::string();
-  SystraceSection s(tracingName.c_str());
-  FbSystraceAsyncFlow::begin(
-      TRACE_TAG_REACT_CXX_BRIDGE,
-      tracingName.c_str(),
-      systraceCookie);
-  #else
   std::string tracingName;
-  #endif
+  if (isSystracing()) {
+    systraceCookie = m_systraceCookie++;
+    tracingName = folly::to<std::string>("JSCall__", module, '_', method);
+  }
+  SystraceSection s(tracingName.c_str());
+  if (systraceCookie != -1) {
+    SystraceAsyncFlow::begin(tracingName.c_str(), systraceCookie);
+  }
 
+  size_t queuedBytes = MemoryAccounting::payloadSizesEnabled()
+    ? module.size() + method.size() + MemoryAccounting::estimateSize(arguments)
+    : 0;
   runOnExecutorQueue([module = std::move(module), method = std::move(method), arguments = std::move(arguments), tracingName = std::move(tracingName), systraceCookie]
     (JSExecutor* executor) {
-      #ifdef WITH_FBSYSTRACE
-      FbSystraceAsyncFlow::end(
-          TRACE_TAG_REACT_CXX_BRIDGE,
-          tracingName.c_str(),
-          systraceCookie);
+      if (systraceCookie != -1) {
+        SystraceAsyncFlow::end(tracingName.c_str(), systraceCookie);
+      }
       SystraceSection s(tracingName.c_str());
-      #endif
 
       // This is safe because we are running on the executor's thread: it won't
       // destruct until after it's been unregistered (which we check above) and
       // that will happen on this thread
       executor->callFunction(module, method, arguments);
-    });
+    }, queuedBytes);
 }
 
 void NativeToJsBridge::invokeCallback(double callbackId, folly::dynamic&& arguments) {
   int systraceCookie = -1;
-  #ifdef WITH_FBSYSTRACE
-  systraceCookie = m_systraceCookie++;
-  FbSystraceAsyncFlow::begin(
-      TRACE_TAG_REACT_CXX_BRIDGE,
-      "<callback>",
-      systraceCookie);
-  #endif
+  if (isSystracing()) {
+    systraceCookie = m_systraceCookie++;
+    SystraceAsyncFlow::begin("<callback>", systraceCookie);
+  }
 
+  size_t queuedBytes = MemoryAccounting::payloadSizesEnabled()
+    ? MemoryAccounting::estimateSize(arguments)
+    : 0;
   runOnExecutorQueue([callbackId, arguments = std::move(arguments), systraceCookie]
     (JSExecutor* executor) {
-      #ifdef WITH_FBSYSTRACE
-      FbSystraceAsyncFlow::end(
-          TRACE_TAG_REACT_CXX_BRIDGE,
-          "<callback>",
-          systraceCookie);
+      if (systraceCookie != -1) {
+        SystraceAsyncFlow::end("<callback>", systraceCookie);
+      }
       SystraceSection s("NativeToJsBridge.invokeCallback");
-      #endif
 
       executor->invokeCallback(callbackId, arguments);
-    });
+    }, queuedBytes);
 }
 
 void NativeToJsBridge::setGlobalVariable(std::string propName,
@@ -224,6 +239,17 @@ void NativeToJsBridge::handleMemoryPressureCritical() {
   });
 }
 
+void NativeToJsBridge::handleIdle(std::chrono::steady_clock::time_point deadline) {
+  std::shared_ptr<QueueStats> queueStats = m_queueStats;
+  runOnExecutorQueue([queueStats, deadline] (JSExecutor* executor) {
+    // Work queued after the notification was sent would wait for whatever
+    // the executor does with the idle time.
+    if (queueStats->tasks.current() == 0) {
+      executor->handleIdle(deadline);
+    }
+  });
+}
+
 void NativeToJsBridge::destroy() {
   // All calls made through runOnExecutorQueue have an early exit if
   // m_destroyed is true. Setting this before the runOnQueueSync will cause
@@ -236,13 +262,48 @@ void NativeToJsBridge::destroy() {
   });
 }
 
-void NativeToJsBridge::runOnExecutorQueue(std::function<void(JSExecutor*)> task) {
+folly::dynamic NativeToJsBridge::getQueueStats() {
+  return folly::dynamic::object
+    ("pendingTasks", static_cast<int64_t>(m_queueStats->tasks.current()))
+    ("peakPendingTasks", static_cast<int64_t>(m_queueStats->tasks.peak()))
+    ("pendingBytes", static_cast<int64_t>(m_queueStats->bytes.current()))
+    ("peakPendingBytes", static_cast<int64_t>(m_queueStats->bytes.peak()));
+}
+
+folly::dynamic NativeToJsBridge::getExecutorStats() {
+  // Doesn't touch m_executor, which destroy() resets on the JS thread.
+  if (!m_executorStats) {
+    return folly::dynamic::object();
+  }
+  return m_executorStats->toDynamic();
+}
+
+void NativeToJsBridge::runOnExecutorQueue(std::function<void(JSExecutor*)> task, size_t queuedBytes) {
   if (*m_destroyed) {
     return;
   }
 
+  m_queueStats->tasks.add(1);
+  if (queuedBytes) {
+    m_queueStats->bytes.add(queuedBytes);
+    MemoryAccounting::allocate(MemoryTag::QueuedCall, queuedBytes);
+  }
+  if (isSystracing()) {
+    systraceCounter("NativeToJsBridge pending tasks", m_queueStats->tasks.current());
+  }
+
   std::shared_ptr<bool> isDestroyed = m_destroyed;
-  m_executorMessageQueueThread->runOnQueue([this, isDestroyed, task=std::move(task)] {
+  std::shared_ptr<QueueStats> queueStats = m_queueStats;
+  m_executorMessageQueueThread->runOnQueue([this, isDestroyed, queueStats, queuedBytes, task=std::move(task)] {
+    queueStats->tasks.subtract(1);
+    if (queuedBytes) {
+      queueStats->bytes.subtract(queuedBytes);
+      MemoryAccounting::release(MemoryTag::QueuedCall, queuedBytes);
+    }
+    if (isSystracing()) {
+      systraceCounter("NativeToJsBridge pending tasks", queueStats->tasks.current());
+    }
+
     if (*isDestroyed) {
       return;
     }
@@ -3,13 +3,16 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <functional>
+#include <future>
 #include <map>
 #include <vector>
 
 #include <cxxreact/Executor.h>
 #include <cxxreact/JSCExecutor.h>
 #include <cxxreact/JSModulesUnbundle.h>
+#include <cxxreact/MemoryAccounting.h>
 #include <cxxreact/MessageQueueThread.h>
 #include <cxxreact/MethodCall.h>
 #include <cxxreact/NativeModule.h>
@@ -99,6 +102,14 @@ public:
     std::unique_ptr<JSModulesUnbundle> unbundle,
     std::unique_ptr<const JSBigString> startupCode,
     std::string sourceURL);
+  /**
+   * As above, but the startup code is still being produced on another
+   * thread.  The JS queue waits for it only right before it is evaluated.
+   */
+  void loadApplication(
+    std::unique_ptr<JSModulesUnbundle> unbundle,
+    std::future<std::unique_ptr<const JSBigString>> startupCode,
+    std::string sourceURL);
   void loadApplicationSync(
     std::unique_ptr<JSModulesUnbundle> unbundle,
     std::unique_ptr<const JSBigString> startupCode,
@@ -113,12 +124,37 @@ public:
   void handleMemoryPressureModerate();
   void handleMemoryPressureCritical();
 
+  /**
+   * Offers the executor the time until deadline, if nothing is queued for JS
+   * by the time this reaches the JS thread.
+   */
+  void handleIdle(std::chrono::steady_clock::time_point deadline);
+
+  /**
+   * Backlog of the JS queue: the tasks waiting to run and the bytes of call
+   * arguments they hold, along with the highest each has been. Bytes are only
+   * counted while MemoryAccounting's payload sizes are enabled.
+   */
+  folly::dynamic getQueueStats();
+
+  /**
+   * The executor's own counters, see JSExecutor::getStats(). May be called
+   * from any thread, and keeps reporting the last counts after destroy().
+   */
+  folly::dynamic getExecutorStats();
+
   /**
    * Synchronously tears down the bridge and the main executor.
    */
   void destroy();
 private:
-  void runOnExecutorQueue(std::function<void(JSExecutor*)> task);
+  struct QueueStats {
+    Watermark tasks;
+    Watermark bytes;
+  };
+
+  // queuedBytes is the size of the arguments the task holds on to, if any.
+  void runOnExecutorQueue(std::function<void(JSExecutor*)> task, size_t queuedBytes = 0);
 
   // This is used to avoid a race condition where a proxyCallback gets queued
   // after ~NativeToJsBridge(), on the same thread. In that case, the callback
@@ -127,11 +163,14 @@ private:
   std::shared_ptr<bool> m_destroyed;
   std::shared_ptr<JsToNativeBridge> m_delegate;
   std::unique_ptr<JSExecutor> m_executor;
+  // Taken from the executor when it is created, so that it may be read from
+  // any thread, see getExecutorStats().
+  std::shared_ptr<const JSExecutorStats> m_executorStats;
   std::shared_ptr<MessageQueueThread> m_executorMessageQueueThread;
+  // Shared with queued tasks, which may run after the bridge is gone.
+  std::shared_ptr<QueueStats> m_queueStats;
 
-  #ifdef WITH_FBSYSTRACE
   std::atomic_uint_least32_t m_systraceCookie = ATOMIC_VAR_INIT();
-  #endif
 };
 
 } }
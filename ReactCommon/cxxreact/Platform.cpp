@@ -13,6 +13,11 @@ namespace PerfLogging {
 InstallNativeHooks installNativeHooks;
 };
 
+namespace WebWorkerUtil {
+WebWorkerQueueFactory createWebWorkerThread;
+ScriptLoader loadScript;
+};
+
 namespace JSNativeHooks {
 Hook loggingHook = nullptr;
 Hook nowHook = nullptr;
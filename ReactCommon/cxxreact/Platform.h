@@ -22,6 +22,12 @@ enum ReactMarkerId {
   CREATE_REACT_CONTEXT_STOP,
   JS_BUNDLE_STRING_CONVERT_START,
   JS_BUNDLE_STRING_CONVERT_STOP,
+  CREATE_MODULE_REGISTRY_START,
+  CREATE_MODULE_REGISTRY_STOP,
+  CREATE_JS_CONTEXT_START,
+  CREATE_JS_CONTEXT_STOP,
+  LOAD_JS_BUNDLE_START,
+  LOAD_JS_BUNDLE_STOP,
 };
 using LogMarker = std::function<void(const ReactMarkerId)>;
 extern LogMarker logMarker;
@@ -32,6 +38,15 @@ using InstallNativeHooks = std::function<void(JSGlobalContextRef)>;
 extern InstallNativeHooks installNativeHooks;
 };
 
+namespace WebWorkerUtil {
+using WebWorkerQueueFactory = std::function<std::shared_ptr<MessageQueueThread>(int id, MessageQueueThread* ownerMessageQueue)>;
+extern WebWorkerQueueFactory createWebWorkerThread;
+// Loads the script a worker is started with, or returns null for URLs it
+// doesn't handle.  Those load as file:// URLs or absolute paths, if they are.
+using ScriptLoader = std::function<std::unique_ptr<const JSBigString>(const std::string& url)>;
+extern ScriptLoader loadScript;
+};
+
 namespace JSNativeHooks {
   using Hook = JSValueRef (*) (
       JSContextRef ctx,
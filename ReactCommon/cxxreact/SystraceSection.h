@@ -6,14 +6,17 @@
 #include <fbsystrace.h>
 #endif
 
+#include "Tracer.h"
+
 namespace facebook {
 namespace react {
 
 /**
  * This is a convenience class to avoid lots of verbose profiling
- * #ifdefs.  If WITH_FBSYSTRACE is not defined, the optimizer will
- * remove this completely.  If it is defined, it will behave as
- * FbSystraceSection, with the right tag provided.
+ * #ifdefs.  If WITH_FBSYSTRACE is defined, it will behave as
+ * FbSystraceSection, with the right tag provided. Either way, it records
+ * a section in the built-in Tracer while that is tracing, which costs a
+ * single relaxed load otherwise. Only fbsystrace records the arguments.
  */
 struct SystraceSection {
 public:
@@ -21,13 +24,67 @@ public:
   explicit SystraceSection(const char* name, ConvertsToStringPiece&&... args)
 #ifdef WITH_FBSYSTRACE
     : m_section(TRACE_TAG_REACT_CXX_BRIDGE, name, args...)
+    , m_traced(Tracer::isTracing())
+#else
+    : m_traced(Tracer::isTracing())
 #endif
-  {}
+  {
+    if (m_traced) {
+      Tracer::beginSection(name);
+    }
+  }
+
+  ~SystraceSection() {
+    if (m_traced) {
+      Tracer::endSection();
+    }
+  }
 
 private:
 #ifdef WITH_FBSYSTRACE
   fbsystrace::FbSystraceSection m_section;
 #endif
+  bool m_traced;
 };
 
+/**
+ * Whether either fbsystrace or the built-in Tracer is recording, for callers
+ * that would otherwise compute trace names for nothing.
+ */
+inline bool isSystracing() {
+#ifdef WITH_FBSYSTRACE
+  if (fbsystrace_is_tracing(TRACE_TAG_REACT_CXX_BRIDGE)) {
+    return true;
+  }
+#endif
+  return Tracer::isTracing();
+}
+
+/**
+ * Ties work queued on one thread to where it runs on another, as
+ * FbSystraceAsyncFlow does, in whichever tracer is recording.
+ */
+struct SystraceAsyncFlow {
+  static void begin(const char* name, int cookie) {
+#ifdef WITH_FBSYSTRACE
+    fbsystrace::FbSystraceAsyncFlow::begin(TRACE_TAG_REACT_CXX_BRIDGE, name, cookie);
+#endif
+    Tracer::beginAsyncFlow(name, cookie);
+  }
+
+  static void end(const char* name, int cookie) {
+#ifdef WITH_FBSYSTRACE
+    fbsystrace::FbSystraceAsyncFlow::end(TRACE_TAG_REACT_CXX_BRIDGE, name, cookie);
+#endif
+    Tracer::endAsyncFlow(name, cookie);
+  }
+};
+
+inline void systraceCounter(const char* name, int64_t value) {
+#ifdef WITH_FBSYSTRACE
+  fbsystrace_counter(TRACE_TAG_REACT_CXX_BRIDGE, name, value);
+#endif
+  Tracer::counter(name, value);
+}
+
 }}
@@ -0,0 +1,315 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+enum class EventType : uint64_t {
+  Begin,
+  End,
+  AsyncBegin,
+  AsyncEnd,
+  Counter,
+};
+
+const size_t kNameWords = (Tracer::kMaxNameLength + 1) / sizeof(uint64_t);
+
+// Written by a single thread while others may be dumping it, hence the
+// atomic words, see record() and readEvents().
+struct Slot {
+  std::atomic<uint64_t> timestamp;
+  std::atomic<uint64_t> type;
+  std::atomic<uint64_t> value;
+  std::atomic<uint64_t> name[kNameWords];
+};
+
+struct Event {
+  uint64_t timestamp;
+  EventType type;
+  int64_t value;
+  char name[Tracer::kMaxNameLength + 1];
+};
+
+struct ThreadBuffer {
+  ThreadBuffer(size_t capacity, uint32_t session, int64_t threadId, std::string threadName)
+    : slots(new Slot[capacity])
+    , capacity(capacity)
+    , session(session)
+    , threadId(threadId)
+    , threadName(std::move(threadName)) {}
+
+  const std::unique_ptr<Slot[]> slots;
+  const size_t capacity;
+  const uint32_t session;
+  const int64_t threadId;
+  const std::string threadName;
+  // Number of events written so far, the last capacity of which are held.
+  std::atomic<uint64_t> head{0};
+};
+
+std::mutex gMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> gBuffers;
+size_t gEventsPerThread = Tracer::kDefaultEventsPerThread;
+// Bumped by every start(), making threads replace their buffers.
+std::atomic<uint32_t> gSession{0};
+// Each thread's std::shared_ptr<ThreadBuffer>. pthread keys instead of
+// thread_local, which iOS doesn't support.
+pthread_key_t gBufferKey;
+bool gBufferKeyCreated = false;
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t currentThreadId() {
+#ifdef __linux__
+  return static_cast<int64_t>(syscall(SYS_gettid));
+#else
+  static std::atomic<int64_t> nextThreadId{1};
+  return nextThreadId++;
+#endif
+}
+
+std::string currentThreadName() {
+#ifdef __linux__
+  char name[17] = {};
+  if (prctl(PR_GET_NAME, name) == 0) {
+    return name;
+  }
+#endif
+  return std::string();
+}
+
+ThreadBuffer* thisThreadBuffer() {
+  uint32_t session = gSession.load(std::memory_order_acquire);
+  if (session == 0) {
+    // Not started yet, so the key doesn't exist either.
+    return nullptr;
+  }
+  auto buffer = static_cast<std::shared_ptr<ThreadBuffer>*>(pthread_getspecific(gBufferKey));
+  if (buffer && (*buffer)->session == session) {
+    return buffer->get();
+  }
+
+  std::lock_guard<std::mutex> lock(gMutex);
+  auto newBuffer = std::make_shared<ThreadBuffer>(
+    gEventsPerThread, gSession.load(), currentThreadId(), currentThreadName());
+  gBuffers.push_back(newBuffer);
+  if (buffer) {
+    *buffer = std::move(newBuffer);
+  } else {
+    buffer = new std::shared_ptr<ThreadBuffer>(std::move(newBuffer));
+    pthread_setspecific(gBufferKey, buffer);
+  }
+  return buffer->get();
+}
+
+void record(EventType type, const char* name, int64_t value) {
+  if (!Tracer::isTracing()) {
+    return;
+  }
+  ThreadBuffer* buffer = thisThreadBuffer();
+  if (!buffer) {
+    return;
+  }
+
+  uint64_t nameWords[kNameWords] = {};
+  if (name) {
+    memcpy(nameWords, name, strnlen(name, Tracer::kMaxNameLength));
+  }
+
+  uint64_t index = buffer->head.load(std::memory_order_relaxed);
+  Slot& slot = buffer->slots[index % buffer->capacity];
+  // Readers that see any of the words below also see head at index, and so
+  // know the slot's previous event may be gone.
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.timestamp.store(nowNs(), std::memory_order_relaxed);
+  slot.type.store(static_cast<uint64_t>(type), std::memory_order_relaxed);
+  slot.value.store(static_cast<uint64_t>(value), std::memory_order_relaxed);
+  for (size_t i = 0; i < kNameWords; i++) {
+    slot.name[i].store(nameWords[i], std::memory_order_relaxed);
+  }
+  buffer->head.store(index + 1, std::memory_order_release);
+}
+
+std::vector<Event> readEvents(const ThreadBuffer& buffer) {
+  uint64_t end = buffer.head.load(std::memory_order_acquire);
+  uint64_t begin = end > buffer.capacity ? end - buffer.capacity : 0;
+
+  std::vector<Event> events(end - begin);
+  for (uint64_t index = begin; index < end; index++) {
+    const Slot& slot = buffer.slots[index % buffer.capacity];
+    Event& event = events[index - begin];
+    event.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+    event.type = static_cast<EventType>(slot.type.load(std::memory_order_relaxed));
+    event.value = static_cast<int64_t>(slot.value.load(std::memory_order_relaxed));
+    uint64_t nameWords[kNameWords];
+    for (size_t i = 0; i < kNameWords; i++) {
+      nameWords[i] = slot.name[i].load(std::memory_order_relaxed);
+    }
+    memcpy(event.name, nameWords, sizeof(event.name));
+    event.name[Tracer::kMaxNameLength] = '\0';
+  }
+
+  // Events the thread may have started overwriting while they were copied
+  // are dropped.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t written = buffer.head.load(std::memory_order_relaxed);
+  if (written >= begin + buffer.capacity) {
+    uint64_t firstIntact = written - buffer.capacity + 1;
+    events.erase(events.begin(), events.begin() + std::min(firstIntact - begin, end - begin));
+  }
+  return events;
+}
+
+void appendJsonString(std::ostringstream& out, const char* value) {
+  out << '"';
+  for (; *value; value++) {
+    char c = *value;
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      static const char* hex = "0123456789abcdef";
+      out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+// Trace timestamps are in microseconds.
+void appendJsonMicros(std::ostringstream& out, uint64_t timeNs) {
+  uint64_t fraction = timeNs % 1000;
+  out << timeNs / 1000 << '.'
+      << char('0' + fraction / 100) << char('0' + fraction / 10 % 10) << char('0' + fraction % 10);
+}
+
+} // namespace
+
+const size_t Tracer::kDefaultEventsPerThread;
+const size_t Tracer::kMaxNameLength;
+
+std::atomic<bool> Tracer::s_tracing{false};
+
+void Tracer::start(size_t eventsPerThread) {
+  std::lock_guard<std::mutex> lock(gMutex);
+  if (!gBufferKeyCreated) {
+    pthread_key_create(&gBufferKey, [] (void* buffer) {
+      delete static_cast<std::shared_ptr<ThreadBuffer>*>(buffer);
+    });
+    gBufferKeyCreated = true;
+  }
+  gBuffers.clear();
+  gEventsPerThread = std::max<size_t>(eventsPerThread, 1);
+  gSession++;
+  s_tracing = true;
+}
+
+void Tracer::stop() {
+  s_tracing = false;
+}
+
+void Tracer::beginSection(const char* name) {
+  record(EventType::Begin, name, 0);
+}
+
+void Tracer::endSection() {
+  record(EventType::End, nullptr, 0);
+}
+
+void Tracer::beginAsyncFlow(const char* name, int cookie) {
+  record(EventType::AsyncBegin, name, cookie);
+}
+
+void Tracer::endAsyncFlow(const char* name, int cookie) {
+  record(EventType::AsyncEnd, name, cookie);
+}
+
+void Tracer::counter(const char* name, int64_t value) {
+  record(EventType::Counter, name, value);
+}
+
+std::string Tracer::dumpChromeTrace() {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(gMutex);
+    buffers = gBuffers;
+  }
+
+  const int pid = getpid();
+  std::ostringstream out;
+  out << "{\"traceEvents\":[";
+  const char* separator = "\n";
+  for (const auto& buffer : buffers) {
+    if (!buffer->threadName.empty()) {
+      out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+          << ",\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+      appendJsonString(out, buffer->threadName.c_str());
+      out << "}}";
+      separator = ",\n";
+    }
+
+    for (const Event& event : readEvents(*buffer)) {
+      out << separator << "{\"pid\":" << pid << ",\"tid\":" << buffer->threadId << ",\"ts\":";
+      appendJsonMicros(out, event.timestamp);
+      switch (event.type) {
+        case EventType::Begin:
+          out << ",\"ph\":\"B\",\"cat\":\"react\",\"name\":";
+          appendJsonString(out, event.name);
+          break;
+        case EventType::End:
+          out << ",\"ph\":\"E\"";
+          break;
+        case EventType::AsyncBegin:
+        case EventType::AsyncEnd:
+          out << ",\"ph\":\"" << (event.type == EventType::AsyncBegin ? 's' : 'f')
+              << "\",\"cat\":\"react\",\"id\":" << event.value << ",\"name\":";
+          appendJsonString(out, event.name);
+          break;
+        case EventType::Counter:
+          out << ",\"ph\":\"C\",\"name\":";
+          appendJsonString(out, event.name);
+          out << ",\"args\":{\"value\":" << event.value << "}";
+          break;
+      }
+      out << "}";
+      separator = ",\n";
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  return out.str();
+}
+
+void Tracer::writeChromeTrace(const std::string& path) {
+  const std::string trace = dumpChromeTrace();
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(trace.data(), trace.size());
+  out.close();
+  if (!out) {
+    throw std::runtime_error("Could not write trace to " + path);
+  }
+}
+
+} }
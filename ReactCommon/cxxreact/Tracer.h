@@ -0,0 +1,66 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifndef RN_EXPORT
+#define RN_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace facebook {
+namespace react {
+
+/**
+ * Tracer built into the bridge, so that SystraceSection and friends record
+ * something in builds without fbsystrace.
+ *
+ * While tracing, each thread writes its events into a ring buffer of its own,
+ * without taking locks, replacing its oldest events once the buffer is full.
+ * A full buffer dumps one event fewer than it holds, as that slot may be
+ * mid-overwrite. Names are copied, truncated to kMaxNameLength characters.
+ * Timestamps are in nanoseconds of the monotonic clock.
+ */
+class RN_EXPORT Tracer {
+public:
+  static const size_t kDefaultEventsPerThread = 8192;
+  static const size_t kMaxNameLength = 71;
+
+  /**
+   * Drops the events of any earlier session and starts recording.
+   */
+  static void start(size_t eventsPerThread = kDefaultEventsPerThread);
+  static void stop();
+
+  static bool isTracing() {
+    return s_tracing.load(std::memory_order_relaxed);
+  }
+
+  static void beginSection(const char* name);
+  static void endSection();
+  // Marks work handed from one thread to another; ends with the same name and
+  // cookie are tied to their begin.
+  static void beginAsyncFlow(const char* name, int cookie);
+  static void endAsyncFlow(const char* name, int cookie);
+  static void counter(const char* name, int64_t value);
+
+  /**
+   * The events currently held, as Chrome trace event JSON, which
+   * chrome://tracing and Perfetto open. Can be called while tracing.
+   */
+  static std::string dumpChromeTrace();
+
+  /**
+   * Writes dumpChromeTrace() to path, replacing the file. Throws
+   * std::runtime_error if it can't be written.
+   */
+  static void writeChromeTrace(const std::string& path);
+
+private:
+  static std::atomic<bool> s_tracing;
+};
+
+} }
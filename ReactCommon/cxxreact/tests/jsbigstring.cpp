@@ -11,7 +11,7 @@ using namespace facebook;
 using namespace facebook::react;
 
 namespace {
-int tempFileFromString(std::string contents)
+int tempFileFromString(std::string contents, std::string* path = nullptr)
 {
   std::string tmp {getenv("TMPDIR")};
   tmp += "/temp.XXXXXX";
@@ -22,6 +22,9 @@ int tempFileFromString(std::string contents)
   const int fd = mkstemp(tmpBuf.data());
   write(fd, contents.c_str(), contents.size() + 1);
 
+  if (path) {
+    *path = tmpBuf.data();
+  }
   return fd;
 }
 };
@@ -55,3 +58,33 @@ TEST(JSBigFileString, MapPartTest) {
     ASSERT_EQ(needle[i], bigStr.c_str()[i]);
   }
 }
+
+TEST(JSBigFileString, CheckAsciiTest) {
+  JSBigFileString ascii {tempFileFromString("plain"), 5};
+  ascii.checkAscii();
+  ASSERT_TRUE(ascii.isAscii());
+
+  JSBigFileString nonAscii {tempFileFromString("caf\xc3\xa9"), 5};
+  ASSERT_TRUE(nonAscii.isAscii());
+  nonAscii.checkAscii();
+  ASSERT_FALSE(nonAscii.isAscii());
+}
+
+TEST(JSBigFileString, FromPathTest) {
+  std::string data {"Hello, world"};
+  const auto size = data.length() + 1;
+
+  // Initialise Big String
+  std::string path;
+  close(tempFileFromString(data, &path));
+  auto bigStr = JSBigFileString::fromPath(path);
+
+  // Test
+  ASSERT_EQ(size, bigStr->size());
+  ASSERT_STREQ(data.c_str(), bigStr->c_str());
+  unlink(path.c_str());
+}
+
+TEST(JSBigFileString, FromMissingPathTest) {
+  ASSERT_THROW(JSBigFileString::fromPath("/does/not/exist"), std::system_error);
+}
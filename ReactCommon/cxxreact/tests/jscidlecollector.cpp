@@ -0,0 +1,50 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <cxxreact/JSCIdleCollector.h>
+
+using namespace facebook::react;
+
+namespace {
+
+JSCIdleCollector::Clock::time_point inMs(int ms) {
+  return JSCIdleCollector::Clock::now() + std::chrono::milliseconds(ms);
+}
+
+}
+
+TEST(JSCIdleCollector, CollectsOnlyAfterActivity) {
+  JSGlobalContextRef ctx = JSC_JSGlobalContextCreateInGroup(false, nullptr, nullptr);
+  JSCIdleCollector collector(ctx, JSCIdleCollector::Config{});
+  auto stats = collector.getStats();
+
+  collector.collectIfIdle(inMs(1000));
+  ASSERT_EQ(0, stats->collections);
+
+  collector.onActivity();
+  collector.collectIfIdle(inMs(1000));
+  ASSERT_EQ(1, stats->collections);
+
+  collector.collectIfIdle(inMs(1000));
+  ASSERT_EQ(1, stats->collections);
+
+  JSC_JSGlobalContextRelease(ctx);
+}
+
+TEST(JSCIdleCollector, SkipsWhenTheFrameIsDueTooSoon) {
+  JSGlobalContextRef ctx = JSC_JSGlobalContextCreateInGroup(false, nullptr, nullptr);
+  JSCIdleCollector::Config config;
+  config.budget = std::chrono::milliseconds(8);
+  JSCIdleCollector collector(ctx, config);
+  auto stats = collector.getStats();
+
+  collector.onActivity();
+  collector.collectIfIdle(inMs(1));
+  ASSERT_EQ(0, stats->collections);
+  ASSERT_EQ(1, stats->skippedForDeadline);
+
+  collector.collectIfIdle(inMs(1000));
+  ASSERT_EQ(1, stats->collections);
+
+  JSC_JSGlobalContextRelease(ctx);
+}
@@ -0,0 +1,185 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <cxxreact/JSCWorker.h>
+#include <cxxreact/MessageQueueThread.h>
+#include <folly/Memory.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::react;
+
+#ifdef ANDROID
+#include <android/looper.h>
+static void prepare() {
+  ALooper_prepare(0);
+}
+#else
+static void prepare() {}
+#endif
+
+namespace {
+
+// Runs work in order on a detached thread, which quits like a
+// MessageQueueThreadImpl: from its own thread without waiting, and from any
+// other thread once the work in progress has finished.
+class ThreadQueue : public MessageQueueThread {
+public:
+  ThreadQueue() : m_state(std::make_shared<State>()) {
+    std::thread([state=m_state] {
+      prepare();
+      state->run();
+    }).detach();
+  }
+
+  ~ThreadQueue() {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->quit = true;
+    m_state->cv.notify_all();
+  }
+
+  void runOnQueue(std::function<void()>&& runnable) override {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->work.push_back(std::move(runnable));
+    m_state->cv.notify_all();
+  }
+
+  void runOnQueueSync(std::function<void()>&& runnable) override {
+    std::terminate();
+  }
+
+  void quitSynchronous() override {
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->quit = true;
+    m_state->cv.notify_all();
+    if (std::this_thread::get_id() != m_state->threadId) {
+      m_state->cv.wait(lock, [this] { return m_state->finished; });
+    }
+  }
+
+  void waitUntilFinished() {
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->cv.wait(lock, [this] { return m_state->finished; });
+  }
+
+private:
+  struct State {
+    void run() {
+      std::unique_lock<std::mutex> lock(mutex);
+      threadId = std::this_thread::get_id();
+      while (true) {
+        cv.wait(lock, [this] { return quit || !work.empty(); });
+        if (quit) {
+          break;
+        }
+        auto runnable = std::move(work.front());
+        work.pop_front();
+        lock.unlock();
+        runnable();
+        runnable = nullptr;
+        lock.lock();
+      }
+      work.clear();
+      finished = true;
+      cv.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> work;
+    std::thread::id threadId;
+    bool quit = false;
+    bool finished = false;
+  };
+
+  std::shared_ptr<State> m_state;
+};
+
+class MessageCollector {
+public:
+  JSCWorker::MessageHandler handler() {
+    return [this] (std::string&& message) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_messages.push_back(std::move(message));
+      m_cv.notify_all();
+    };
+  }
+
+  std::string waitForMessage() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_messages.empty(); });
+    return m_messages.front();
+  }
+
+  size_t count() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_messages.size();
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<std::string> m_messages;
+};
+
+std::unique_ptr<const JSBigString> script(std::string source) {
+  return folly::make_unique<JSBigStdString>(std::move(source));
+}
+
+}
+
+TEST(JSCWorker, ExchangesMessagesWithOwner) {
+  auto queue = std::make_shared<ThreadQueue>();
+  MessageCollector owner;
+  JSCWorker worker(1, queue, owner.handler());
+
+  worker.loadScript(script("onmessage = function(e) { postMessage(e.data.n * 2); };"), "worker.js");
+  worker.postMessage("{\"n\": 21}");
+  ASSERT_EQ("42", owner.waitForMessage());
+
+  worker.terminate();
+  queue->waitUntilFinished();
+}
+
+TEST(JSCWorker, TerminateDoesNotWaitForBusyWorker) {
+  auto queue = std::make_shared<ThreadQueue>();
+  MessageCollector owner;
+  auto worker = folly::make_unique<JSCWorker>(2, queue, owner.handler());
+
+  worker->loadScript(
+    script("postMessage('started'); var end = Date.now() + 500; while (Date.now() < end) {}"),
+    "busy.js");
+  owner.waitForMessage();
+
+  auto start = std::chrono::steady_clock::now();
+  worker.reset();
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(250));
+
+  queue->waitUntilFinished();
+}
+
+TEST(JSCWorker, StopsPostingToOwnerOnceTerminated) {
+  auto queue = std::make_shared<ThreadQueue>();
+  MessageCollector owner;
+  JSCWorker worker(3, queue, owner.handler());
+
+  worker.loadScript(
+    script("onmessage = function(e) {"
+           "  var end = Date.now() + 200; while (Date.now() < end) {}"
+           "  postMessage('too late');"
+           "};"),
+    "slow.js");
+  worker.postMessage("null");
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  worker.terminate();
+  worker.postMessage("null");
+
+  queue->waitUntilFinished();
+  ASSERT_EQ(0, owner.count());
+}
@@ -0,0 +1,72 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <cxxreact/JSIndexedRAMBundle.h>
+
+using namespace facebook;
+using namespace facebook::react;
+
+namespace {
+
+// A RAM bundle holding the given startup code and modules, on little endian
+// hosts. Returns its path.
+std::string writeBundle(const std::string& startup, const std::vector<std::string>& modules) {
+  std::vector<uint32_t> header {
+    0xFB0BD1E5,
+    static_cast<uint32_t>(modules.size()),
+    static_cast<uint32_t>(startup.size() + 1),
+  };
+  std::string code;
+  for (const auto& module : modules) {
+    header.push_back(startup.size() + 1 + code.size());
+    header.push_back(module.size() + 1);
+    code += module;
+    code.push_back('\0');
+  }
+
+  std::string path {getenv("TMPDIR")};
+  path += "/bundle.XXXXXX";
+  std::vector<char> pathBuf {path.begin(), path.end()};
+  pathBuf.push_back('\0');
+  const int fd = mkstemp(pathBuf.data());
+  write(fd, header.data(), header.size() * sizeof(uint32_t));
+  write(fd, startup.c_str(), startup.size() + 1);
+  write(fd, code.data(), code.size());
+  close(fd);
+  return pathBuf.data();
+}
+
+}
+
+TEST(JSIndexedRAMBundle, ServesModules) {
+  JSIndexedRAMBundle bundle {writeBundle("startup();", {"a();", "bb();"}).c_str()};
+
+  ASSERT_STREQ("startup();", bundle.getStartupCode()->c_str());
+  auto module = bundle.getModuleSource(1);
+  ASSERT_EQ("1.js", module.name);
+  ASSERT_EQ(5, module.code->size());
+  ASSERT_STREQ("bb();", module.code->c_str());
+  ASSERT_THROW(bundle.getModuleSource(2), std::ios_base::failure);
+}
+
+TEST(JSIndexedRAMBundle, ReleasedModulesStayReadable) {
+  JSIndexedRAMBundle bundle {writeBundle("startup();", {"a();", "bb();"}).c_str()};
+  auto startup = bundle.getStartupCode();
+  ASSERT_EQ(11, bundle.residentSize());
+  auto module = bundle.getModuleSource(0);
+  ASSERT_EQ(16, bundle.residentSize());
+
+  bundle.releaseMemory();
+  ASSERT_EQ(0, bundle.residentSize());
+  ASSERT_STREQ("startup();", startup->c_str());
+  ASSERT_STREQ("a();", module.code->c_str());
+  ASSERT_STREQ("bb();", bundle.getModuleSource(1).code->c_str());
+  ASSERT_EQ(6, bundle.residentSize());
+}
@@ -0,0 +1,110 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <cxxreact/JSSegmentedBundle.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+using namespace facebook::react;
+
+namespace {
+
+void appendWord(std::string& bundle, uint32_t word) {
+  for (int i = 0; i < 4; i++) {
+    bundle.push_back(static_cast<char>((word >> (8 * i)) & 0xff));
+  }
+}
+
+// Header, segment table and the segments back to back, in order.
+std::string makeBundle(const std::vector<std::string>& segments) {
+  std::string bundle;
+  appendWord(bundle, 0xFB0B5E65);
+  appendWord(bundle, segments.size());
+  appendWord(bundle, 0);
+
+  uint32_t offset = 12 + 8 * segments.size();
+  for (const auto& segment : segments) {
+    appendWord(bundle, offset);
+    appendWord(bundle, segment.size());
+    offset += segment.size();
+  }
+  for (const auto& segment : segments) {
+    bundle += segment;
+  }
+  return bundle;
+}
+
+std::string tempFileFromString(const std::string& contents) {
+  std::string path {getenv("TMPDIR")};
+  path += "/temp.XXXXXX";
+  std::vector<char> pathBuf {path.begin(), path.end()};
+  pathBuf.push_back('\0');
+
+  const int fd = mkstemp(pathBuf.data());
+  write(fd, contents.c_str(), contents.size());
+  close(fd);
+  return pathBuf.data();
+}
+
+}
+
+TEST(JSSegmentedBundle, ReadsSegmentsInOrder) {
+  JSBigStdString script {makeBundle({"var a = 1;\nvar b = 2;\n", "a + b;\n", "done();"})};
+  ASSERT_TRUE(JSSegmentedBundle::isSegmentedBundle(script));
+
+  JSSegmentedBundle bundle(script);
+  ASSERT_EQ(3, bundle.segmentCount());
+
+  auto first = bundle.next();
+  ASSERT_TRUE(first.hasValue());
+  ASSERT_STREQ("var a = 1;\nvar b = 2;\n", first->code->c_str());
+  ASSERT_EQ(1, first->startLine);
+
+  auto second = bundle.next();
+  ASSERT_TRUE(second.hasValue());
+  ASSERT_STREQ("a + b;\n", second->code->c_str());
+  ASSERT_EQ(3, second->startLine);
+
+  auto third = bundle.next();
+  ASSERT_TRUE(third.hasValue());
+  ASSERT_STREQ("done();", third->code->c_str());
+  ASSERT_EQ(4, third->startLine);
+
+  ASSERT_FALSE(bundle.next().hasValue());
+}
+
+TEST(JSSegmentedBundle, ReadsSegmentsFromFile) {
+  auto path = tempFileFromString(makeBundle({"first();\n", "second();\n"}));
+  auto script = JSBigFileString::fromPath(path);
+  ASSERT_TRUE(JSSegmentedBundle::isSegmentedBundle(*script));
+
+  JSSegmentedBundle bundle(*script);
+  ASSERT_STREQ("first();\n", bundle.next()->code->c_str());
+  auto second = bundle.next();
+  ASSERT_STREQ("second();\n", second->code->c_str());
+  ASSERT_EQ(2, second->startLine);
+  ASSERT_FALSE(bundle.next().hasValue());
+  unlink(path.c_str());
+}
+
+TEST(JSSegmentedBundle, IgnoresPlainScripts) {
+  JSBigStdString script {"var plainScript = true;"};
+  ASSERT_FALSE(JSSegmentedBundle::isSegmentedBundle(script));
+
+  JSBigStdString tiny {"1"};
+  ASSERT_FALSE(JSSegmentedBundle::isSegmentedBundle(tiny));
+}
+
+TEST(JSSegmentedBundle, RejectsMalformedTables) {
+  std::string truncatedTable = makeBundle({"a();", "b();"}).substr(0, 20);
+  JSBigStdString tableScript {truncatedTable};
+  ASSERT_THROW(JSSegmentedBundle bundle(tableScript), std::runtime_error);
+
+  std::string complete = makeBundle({"a();"});
+  JSBigStdString segmentScript {complete.substr(0, complete.size() - 1)};
+  ASSERT_THROW(JSSegmentedBundle bundle(segmentScript), std::runtime_error);
+}
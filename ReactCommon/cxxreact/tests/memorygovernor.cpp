@@ -0,0 +1,36 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <cxxreact/MemoryGovernor.h>
+
+using namespace facebook::react;
+
+TEST(MemoryGovernor, TrimsProgressively) {
+  MemoryGovernor governor;
+  size_t moderate = 100;
+  size_t critical = 1000;
+  governor.registerCache(
+    "moderate", MemoryPressure::Moderate,
+    [&] { return moderate; }, [&] (MemoryPressure) { moderate = 0; });
+  governor.registerCache(
+    "critical", MemoryPressure::Critical,
+    [&] { return critical; }, [&] (MemoryPressure) { critical = 0; });
+
+  ASSERT_EQ(1100, governor.size());
+  ASSERT_EQ(0, governor.trim(MemoryPressure::UiHidden));
+  ASSERT_EQ(100, governor.trim(MemoryPressure::Moderate));
+  ASSERT_EQ(1000, governor.trim(MemoryPressure::Critical));
+  ASSERT_EQ(0, governor.size());
+}
+
+TEST(MemoryGovernor, UnregisteredCachesAreNotTrimmed) {
+  MemoryGovernor governor;
+  bool trimmed = false;
+  int id = governor.registerCache(
+    "cache", MemoryPressure::UiHidden,
+    [] { return 10; }, [&] (MemoryPressure) { trimmed = true; });
+  governor.unregisterCache(id);
+
+  ASSERT_EQ(0, governor.trim(MemoryPressure::Critical));
+  ASSERT_FALSE(trimmed);
+}
@@ -0,0 +1,129 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <microprofiler/MicroProfiler.h>
+
+#include <atomic>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::react;
+
+TEST(MicroProfiler, PlacesTimesInTheirBuckets) {
+  std::vector<uint64_t> times {0, 1, 7, 8, 9, 15, 16, 17, 18, 100, 1000, 123456789,
+                               std::numeric_limits<uint64_t>::max()};
+  for (uint64_t timeNs : times) {
+    uint32_t bucket = MicroProfiler::histogramBucket(timeNs);
+    ASSERT_LT(bucket, kMicroProfilerHistogramBuckets) << timeNs;
+    ASSERT_LE(MicroProfiler::histogramBucketLowerBoundNs(bucket), timeNs);
+    if (bucket + 1 < kMicroProfilerHistogramBuckets) {
+      ASSERT_LT(timeNs, MicroProfiler::histogramBucketLowerBoundNs(bucket + 1));
+    }
+  }
+  ASSERT_EQ(7, MicroProfiler::histogramBucket(7));
+  ASSERT_EQ(MicroProfiler::histogramBucket(16), MicroProfiler::histogramBucket(17));
+  ASSERT_NE(MicroProfiler::histogramBucket(17), MicroProfiler::histogramBucket(18));
+}
+
+TEST(MicroProfiler, BucketsStayWithinAnEighthOfTheirBounds) {
+  for (uint32_t bucket = kMicroProfilerHistogramSubBuckets;
+       bucket + 1 < kMicroProfilerHistogramBuckets; bucket++) {
+    uint64_t lower = MicroProfiler::histogramBucketLowerBoundNs(bucket);
+    uint64_t next = MicroProfiler::histogramBucketLowerBoundNs(bucket + 1);
+    ASSERT_EQ(bucket, MicroProfiler::histogramBucket(lower));
+    ASSERT_EQ(bucket, MicroProfiler::histogramBucket(next - 1));
+    ASSERT_LE(next - lower, lower / kMicroProfilerHistogramSubBuckets);
+  }
+}
+
+TEST(MicroProfiler, ReadsPercentilesFromTheHistogram) {
+  MicroProfilerSectionStats section;
+  section.calls = 100;
+  section.minNs = 10;
+  section.maxNs = 1020;
+  section.histogram.assign(kMicroProfilerHistogramBuckets, 0);
+  section.histogram[MicroProfiler::histogramBucket(10)] = 90;
+  section.histogram[MicroProfiler::histogramBucket(1000)] = 10;
+
+  // Buckets below 16ns are a nanosecond wide.
+  ASSERT_EQ(10, section.percentileNs(0));
+  ASSERT_EQ(10, section.percentileNs(0.5));
+  ASSERT_EQ(10, section.percentileNs(0.89));
+  // 1000ns falls in [960, 1024), capped by the slowest call.
+  ASSERT_EQ(1020, section.percentileNs(0.9));
+  ASSERT_EQ(1020, section.percentileNs(0.99));
+  ASSERT_EQ(1020, section.percentileNs(1));
+}
+
+TEST(MicroProfiler, ExportsChromeTraceJson) {
+  MicroProfilerSnapshot snapshot;
+  snapshot.startTimeNs = 1000;
+  snapshot.endTimeNs = 9000;
+  snapshot.clockOverheadNs = 20;
+  snapshot.profileSectionOverheadNs = 30;
+  snapshot.sectionNames = {"plain", "quoted \"name\"\n"};
+
+  MicroProfilerThreadSnapshot thread;
+  thread.threadIndex = 3;
+  thread.droppedEvents = 2;
+  MicroProfilerSectionStats section;
+  section.name = 1;
+  section.calls = 1;
+  section.totalNs = 2001;
+  section.minNs = 2001;
+  section.maxNs = 2001;
+  section.histogram.assign(kMicroProfilerHistogramBuckets, 0);
+  section.histogram[MicroProfiler::histogramBucket(2001)] = 1;
+  thread.sections.push_back(section);
+  thread.events.push_back({1, 1500, 2001});
+  snapshot.threads.push_back(thread);
+
+  std::string json = snapshot.toChromeTraceJson();
+  ASSERT_EQ(0, json.find("{\"traceEvents\":["));
+  ASSERT_NE(std::string::npos, json.find(
+      "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,"
+      "\"args\":{\"name\":\"MicroProfiler thread 3\"}}"));
+  ASSERT_NE(std::string::npos, json.find(
+      "{\"name\":\"quoted \\\"name\\\"\\u000a\",\"cat\":\"microprofiler\",\"ph\":\"X\","
+      "\"pid\":1,\"tid\":3,\"ts\":1.500,\"dur\":2.001}"));
+  ASSERT_NE(std::string::npos, json.find(
+      "\"otherData\":{\"durationNs\":8000,\"clockOverheadNs\":20,"
+      "\"profileSectionOverheadNs\":30,\"microProfilerSections\":["));
+  ASSERT_NE(std::string::npos, json.find(
+      "\"tid\":3,\"calls\":1,\"totalNs\":2001,\"minNs\":2001,\"p50Ns\":2001,"
+      "\"p90Ns\":2001,\"p99Ns\":2001,\"maxNs\":2001,\"droppedEvents\":2}"));
+  ASSERT_EQ(json.size() - 4, json.rfind("]}}\n"));
+}
+
+#if !defined(__APPLE__)
+// Threads keep recording while profiling is stopped and started again with a
+// different number of events, which resizes their event buffers.
+TEST(MicroProfiler, RestartsWhileOtherThreadsRecord) {
+  auto name = MicroProfiler::registerSection("restarted");
+  std::atomic_bool done {false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&] {
+      while (!done) {
+        MicroProfilerSection section(name);
+      }
+    });
+  }
+
+  for (uint32_t events = 0; events < 4; events++) {
+    MicroProfiler::startProfiling(events * 16);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    auto snapshot = MicroProfiler::stopProfiling();
+    for (const auto& thread : snapshot.threads) {
+      ASSERT_LE(thread.events.size(), events * 16);
+    }
+  }
+
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+#endif
@@ -0,0 +1,101 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <cxxreact/SystraceSection.h>
+#include <cxxreact/Tracer.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace facebook::react;
+
+static size_t countOccurrences(const std::string& haystack, const std::string& needle) {
+  size_t count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + needle.size())) {
+    count++;
+  }
+  return count;
+}
+
+TEST(Tracer, RecordsNothingUnlessStarted) {
+  Tracer::stop();
+  Tracer::start();
+  Tracer::stop();
+  {
+    SystraceSection s("untraced");
+  }
+  ASSERT_EQ(std::string::npos, Tracer::dumpChromeTrace().find("untraced"));
+}
+
+TEST(Tracer, RecordsSectionsFlowsAndCounters) {
+  Tracer::start();
+  {
+    SystraceSection s("outer \"section\"");
+    SystraceAsyncFlow::begin("flow", 7);
+    std::thread([] {
+      SystraceAsyncFlow::end("flow", 7);
+      SystraceSection s("inner");
+      systraceCounter("pending", 3);
+    }).join();
+  }
+  Tracer::stop();
+
+  std::string trace = Tracer::dumpChromeTrace();
+  ASSERT_EQ(0, trace.find("{\"traceEvents\":["));
+  ASSERT_NE(std::string::npos, trace.find("\"name\":\"outer \\\"section\\\"\""));
+  ASSERT_NE(std::string::npos, trace.find("\"ph\":\"s\",\"cat\":\"react\",\"id\":7"));
+  ASSERT_NE(std::string::npos, trace.find("\"ph\":\"f\",\"cat\":\"react\",\"id\":7"));
+  ASSERT_NE(std::string::npos, trace.find("\"args\":{\"value\":3}"));
+  ASSERT_EQ(2, countOccurrences(trace, "\"ph\":\"B\""));
+  ASSERT_EQ(2, countOccurrences(trace, "\"ph\":\"E\""));
+}
+
+TEST(Tracer, KeepsTheLatestEventsOfEachThread) {
+  Tracer::start(4);
+  for (int i = 0; i < 10; i++) {
+    Tracer::counter("count", i);
+  }
+  Tracer::stop();
+
+  std::string trace = Tracer::dumpChromeTrace();
+  ASSERT_EQ(3, countOccurrences(trace, "\"ph\":\"C\""));
+  ASSERT_EQ(std::string::npos, trace.find("\"value\":6}"));
+  ASSERT_NE(std::string::npos, trace.find("\"value\":7}"));
+  ASSERT_NE(std::string::npos, trace.find("\"value\":9}"));
+}
+
+TEST(Tracer, TruncatesLongNames) {
+  Tracer::start();
+  Tracer::beginSection(std::string(Tracer::kMaxNameLength + 10, 'x').c_str());
+  Tracer::endSection();
+  Tracer::stop();
+
+  std::string trace = Tracer::dumpChromeTrace();
+  ASSERT_NE(std::string::npos, trace.find('"' + std::string(Tracer::kMaxNameLength, 'x') + '"'));
+}
+
+TEST(Tracer, WritesTheDumpToAFile) {
+  Tracer::start();
+  Tracer::beginSection("written");
+  Tracer::endSection();
+  Tracer::stop();
+
+  std::string path = std::string(getenv("TMPDIR")) + "/tracer_XXXXXX";
+  int fd = mkstemp(&path[0]);
+  ASSERT_NE(-1, fd);
+  close(fd);
+  Tracer::writeChromeTrace(path);
+
+  std::ifstream in(path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  unlink(path.c_str());
+  ASSERT_EQ(Tracer::dumpChromeTrace(), contents.str());
+
+  ASSERT_THROW(Tracer::writeChromeTrace("/nonexistent/trace.json"), std::runtime_error);
+}
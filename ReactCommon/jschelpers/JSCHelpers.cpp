@@ -122,12 +122,16 @@ void removeGlobal(JSGlobalContextRef ctx, const char* name) {
   Object::getGlobalObject(ctx).setProperty(name, Value::makeUndefined(ctx));
 }
 
-JSValueRef evaluateScript(JSContextRef context, JSStringRef script, JSStringRef source) {
+JSValueRef evaluateScript(
+    JSContextRef context,
+    JSStringRef script,
+    JSStringRef source,
+    int startingLineNumber) {
   #ifdef WITH_FBSYSTRACE
   fbsystrace::FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "evaluateScript");
   #endif
   JSValueRef exn, result;
-  result = JSC_JSEvaluateScript(context, script, NULL, source, 0, &exn);
+  result = JSC_JSEvaluateScript(context, script, NULL, source, startingLineNumber, &exn);
   if (result == nullptr) {
     formatAndThrowJSException(context, exn, source);
   }
@@ -62,7 +62,8 @@ void removeGlobal(JSGlobalContextRef ctx, const char* name);
 JSValueRef evaluateScript(
     JSContextRef ctx,
     JSStringRef script,
-    JSStringRef sourceURL);
+    JSStringRef sourceURL,
+    int startingLineNumber = 0);
 
 #if WITH_FBJSCEXTENSIONS
 JSValueRef evaluateSourceCode(
@@ -138,6 +138,10 @@ struct JSCWrapper {
   Class JSValue;
 
   int32_t JSBytecodeFileFormatVersion;
+
+  // Members added later go last, so that the members above keep their
+  // offsets in wrappers passed to setCustomJSCWrapper.
+  JSC_WRAPPER_METHOD(JSGarbageCollect);
 };
 
 template <typename T>
@@ -133,6 +133,8 @@ const JSCWrapper* systemJSCWrapper() {
       .JSValue = objc_getClass("JSValue"),
 
       .JSBytecodeFileFormatVersion = JSNoBytecodeFileFormatVersion,
+
+      .JSGarbageCollect = JSGarbageCollect,
     };
   });
   return &s_systemWrapper;
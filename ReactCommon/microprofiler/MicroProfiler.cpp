@@ -2,7 +2,12 @@
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <sstream>
+#include <utility>
 #include <vector>
 #include <time.h>
 
@@ -21,24 +26,159 @@
 namespace facebook {
 namespace react {
 
+uint32_t MicroProfiler::histogramBucket(uint64_t timeNs) {
+  if (timeNs < kMicroProfilerHistogramSubBuckets) {
+    return static_cast<uint32_t>(timeNs);
+  }
+  // Position of the highest set bit, at least 3, followed by the next three bits.
+  uint32_t magnitude = 63 - __builtin_clzll(timeNs);
+  uint32_t subBucket = (timeNs >> (magnitude - 3)) & (kMicroProfilerHistogramSubBuckets - 1);
+  return (magnitude - 2) * kMicroProfilerHistogramSubBuckets + subBucket;
+}
+
+uint64_t MicroProfiler::histogramBucketLowerBoundNs(uint32_t bucket) {
+  if (bucket < kMicroProfilerHistogramSubBuckets) {
+    return bucket;
+  }
+  uint32_t magnitude = bucket / kMicroProfilerHistogramSubBuckets + 2;
+  uint64_t subBucket = bucket % kMicroProfilerHistogramSubBuckets;
+  return (kMicroProfilerHistogramSubBuckets + subBucket) << (magnitude - 3);
+}
+
+uint64_t MicroProfilerSectionStats::percentileNs(double fraction) const {
+  uint64_t rank = static_cast<uint64_t>(fraction * calls);
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < histogram.size(); i++) {
+    seen += histogram[i];
+    if (seen > rank) {
+      if (i + 1 == kMicroProfilerHistogramBuckets) {
+        return maxNs;
+      }
+      return std::min(MicroProfiler::histogramBucketLowerBoundNs(i + 1) - 1, maxNs);
+    }
+  }
+  return maxNs;
+}
+
+static void appendJsonString(std::ostringstream& out, const std::string& value) {
+  out << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          static const char* hex = "0123456789abcdef";
+          out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+static void appendJsonMicros(std::ostringstream& out, uint64_t timeNs) {
+  out << timeNs / 1000 << '.';
+  auto fraction = timeNs % 1000;
+  out << char('0' + fraction / 100) << char('0' + fraction / 10 % 10) << char('0' + fraction % 10);
+}
+
+std::string MicroProfilerSnapshot::toChromeTraceJson() const {
+  std::ostringstream out;
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& thread : threads) {
+    out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+        << thread.threadIndex << ",\"args\":{\"name\":\"MicroProfiler thread "
+        << thread.threadIndex << "\"}}";
+    first = false;
+    for (const auto& event : thread.events) {
+      out << ",\n{\"name\":";
+      appendJsonString(out, sectionNames[event.name]);
+      out << ",\"cat\":\"microprofiler\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadIndex
+          << ",\"ts\":";
+      appendJsonMicros(out, event.startNs);
+      out << ",\"dur\":";
+      appendJsonMicros(out, event.durationNs);
+      out << "}";
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"durationNs\":" << endTimeNs - startTimeNs
+      << ",\"clockOverheadNs\":" << clockOverheadNs
+      << ",\"profileSectionOverheadNs\":" << profileSectionOverheadNs
+      << ",\"microProfilerSections\":[";
+  first = true;
+  for (const auto& thread : threads) {
+    out << (first ? "" : ",");
+    first = false;
+    bool firstSection = true;
+    for (const auto& section : thread.sections) {
+      out << (firstSection ? "" : ",") << "\n{\"name\":";
+      firstSection = false;
+      appendJsonString(out, sectionNames[section.name]);
+      out << ",\"tid\":" << thread.threadIndex
+          << ",\"calls\":" << section.calls
+          << ",\"totalNs\":" << section.totalNs
+          << ",\"minNs\":" << section.minNs
+          << ",\"p50Ns\":" << section.percentileNs(0.5)
+          << ",\"p90Ns\":" << section.percentileNs(0.9)
+          << ",\"p99Ns\":" << section.percentileNs(0.99)
+          << ",\"maxNs\":" << section.maxNs
+          << ",\"droppedEvents\":" << thread.droppedEvents << "}";
+    }
+  }
+  out << "\n]}}\n";
+  return out.str();
+}
+
 #if !MICRO_PROFILER_STUB_IMPLEMENTATION
+// Only written by the thread the data belongs to; others read it through snapshots.
+struct SectionData {
+  std::atomic_uint_fast64_t calls_ = {};
+  std::atomic_uint_fast64_t totalNs_ = {};
+  std::atomic_uint_fast64_t minNs_ = {};
+  std::atomic_uint_fast64_t maxNs_ = {};
+  std::atomic_uint_fast32_t histogram_[kMicroProfilerHistogramBuckets] = {};
+};
+
 struct TraceData {
   TraceData();
   ~TraceData();
 
-  void addTime(MicroProfilerName name, uint_fast64_t time, uint_fast32_t internalClockCalls);
+  void addTime(
+      MicroProfilerName name,
+      uint_fast64_t startTime,
+      uint_fast64_t time,
+      uint_fast32_t childProfileSections);
+  void resizeEvents(uint32_t capacity);
 
   std::thread::id threadId_;
-  uint_fast64_t startTime_;
-  std::atomic_uint_fast64_t times_[MicroProfilerName::__LENGTH__] = {};
-  std::atomic_uint_fast32_t calls_[MicroProfilerName::__LENGTH__] = {};
-  std::atomic_uint_fast32_t childProfileSections_[MicroProfilerName::__LENGTH__] = {};
+  uint32_t threadIndex_;
+  // Set by the owning thread while it may call addTime(). Profiling data is
+  // only cleared or resized once it is unset, see waitForRecording().
+  std::atomic_bool recording_ = {false};
+  std::atomic<SectionData*> sections_[kMicroProfilerMaxSections] = {};
+  std::unique_ptr<MicroProfilerEvent[]> events_;
+  uint32_t eventCapacity_ = 0;
+  std::atomic_uint_fast32_t eventCount_ = {};
+  std::atomic_uint_fast64_t droppedEvents_ = {};
 };
 
 struct ProfilingImpl {
   std::mutex mutex_;
   std::vector<TraceData*> allTraceData_;
-  bool isProfiling_ = false;
+  // A deque keeps the names in place as sections are added.
+  std::deque<std::string> sectionNames_;
+  // What threads that have since exited collected.
+  std::vector<MicroProfilerThreadSnapshot> exitedThreads_;
+  uint32_t nextThreadIndex_ = 0;
+  uint32_t eventsPerThread_ = 0;
+  std::atomic_bool isProfiling_ = {false};
   uint_fast64_t startTime_;
   uint_fast64_t endTime_;
   uint_fast64_t clockOverhead_;
@@ -51,7 +191,7 @@ thread_local uint_fast32_t profileSections = 0;
 
 static uint_fast64_t nowNs() {
   struct timespec time;
-  clock_gettime(CLOCK_REALTIME, &time);
+  clock_gettime(CLOCK_MONOTONIC, &time);
   return uint_fast64_t(1000000000) * time.tv_sec + time.tv_nsec;
 }
 
@@ -72,6 +212,11 @@ static std::string formatTimeNs(uint_fast64_t timeNs) {
   return out.str();
 }
 
+template <typename T>
+static inline void addRelaxed(std::atomic<T>& value, T amount) {
+  value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
 MicroProfilerSection::MicroProfilerSection(MicroProfilerName name) :
     isProfiling_(profiling.isProfiling_),
     name_(name),
@@ -83,66 +228,201 @@ MicroProfilerSection::MicroProfilerSection(MicroProfilerName name) :
   startTime_ = nowNs();
 }
 MicroProfilerSection::~MicroProfilerSection() {
-  if (!isProfiling_ || !profiling.isProfiling_) {
+  if (!isProfiling_) {
     return;
   }
   auto endTime = nowNs();
   auto endNumProfileSections = profileSections;
-  myTraceData.addTime(name_, endTime - startTime_, endNumProfileSections - startNumProfileSections_ - 1);
+  auto& traceData = myTraceData;
+  // Both this and stopping are sequentially consistent, so either profiling is
+  // seen stopped here, or waitForRecording() sees this thread recording.
+  traceData.recording_ = true;
+  if (profiling.isProfiling_) {
+    traceData.addTime(name_, startTime_, endTime - startTime_, endNumProfileSections - startNumProfileSections_ - 1);
+  }
+  traceData.recording_.store(false, std::memory_order_release);
 }
 
 TraceData::TraceData() :
     threadId_(std::this_thread::get_id()) {
   std::lock_guard<std::mutex> lock(profiling.mutex_);
+  threadIndex_ = profiling.nextThreadIndex_++;
+  resizeEvents(profiling.eventsPerThread_);
   profiling.allTraceData_.push_back(this);
 }
 
+static bool snapshotThread(TraceData* info, MicroProfilerThreadSnapshot& thread);
+
 TraceData::~TraceData() {
   std::lock_guard<std::mutex> lock(profiling.mutex_);
+  MicroProfilerThreadSnapshot thread;
+  if (snapshotThread(this, thread)) {
+    profiling.exitedThreads_.push_back(std::move(thread));
+  }
   auto& infos = profiling.allTraceData_;
   infos.erase(std::remove(infos.begin(), infos.end(), this), infos.end());
+  for (auto& section : sections_) {
+    delete section.load();
+  }
 }
 
-void TraceData::addTime(MicroProfilerName name, uint_fast64_t time, uint_fast32_t childprofileSections) {
-  times_[name] += time;
-  calls_[name]++;
-  childProfileSections_[name] += childprofileSections;
+void TraceData::resizeEvents(uint32_t capacity) {
+  if (eventCapacity_ != capacity) {
+    events_.reset(capacity > 0 ? new MicroProfilerEvent[capacity] : nullptr);
+    eventCapacity_ = capacity;
+  }
 }
 
-static void printReport() {
+void TraceData::addTime(
+    MicroProfilerName name,
+    uint_fast64_t startTime,
+    uint_fast64_t time,
+    uint_fast32_t childProfileSections) {
+  auto overhead = profiling.clockOverhead_ + profiling.profileSectionOverhead_ * childProfileSections;
+  auto correctedTime = time > overhead ? time - overhead : 0;
+
+  auto section = sections_[name].load(std::memory_order_relaxed);
+  if (section == nullptr) {
+    section = new SectionData();
+    section->minNs_ = std::numeric_limits<uint_fast64_t>::max();
+    sections_[name].store(section, std::memory_order_release);
+  }
+  addRelaxed<uint_fast64_t>(section->calls_, 1);
+  addRelaxed<uint_fast64_t>(section->totalNs_, correctedTime);
+  if (correctedTime < section->minNs_.load(std::memory_order_relaxed)) {
+    section->minNs_.store(correctedTime, std::memory_order_relaxed);
+  }
+  if (correctedTime > section->maxNs_.load(std::memory_order_relaxed)) {
+    section->maxNs_.store(correctedTime, std::memory_order_relaxed);
+  }
+  addRelaxed<uint_fast32_t>(section->histogram_[MicroProfiler::histogramBucket(correctedTime)], 1);
+
+  auto eventCount = eventCount_.load(std::memory_order_relaxed);
+  if (eventCount < eventCapacity_) {
+    auto& event = events_[eventCount];
+    event.name = name;
+    event.startNs = startTime > profiling.startTime_ ? startTime - profiling.startTime_ : 0;
+    event.durationNs = correctedTime;
+    eventCount_.store(eventCount + 1, std::memory_order_release);
+  } else if (eventCapacity_ > 0) {
+    addRelaxed<uint_fast64_t>(droppedEvents_, 1);
+  }
+}
+
+MicroProfilerName MicroProfiler::registerSection(const std::string& name) {
+  std::lock_guard<std::mutex> lock(profiling.mutex_);
+  auto& names = profiling.sectionNames_;
+  auto existing = std::find(names.begin(), names.end(), name);
+  if (existing != names.end()) {
+    return static_cast<MicroProfilerName>(existing - names.begin());
+  }
+  CHECK(names.size() < kMicroProfilerMaxSections)
+      << "Trying to register more than " << kMicroProfilerMaxSections << " profiler sections";
+  names.push_back(name);
+  return static_cast<MicroProfilerName>(names.size() - 1);
+}
+
+std::string MicroProfiler::profilingNameToString(MicroProfilerName name) {
+  std::lock_guard<std::mutex> lock(profiling.mutex_);
+  CHECK(name < profiling.sectionNames_.size()) << "Trying to convert unknown MicroProfilerName to string";
+  return profiling.sectionNames_[name];
+}
+
+// Expects the mutex to be held. Returns whether the thread collected anything.
+static bool snapshotThread(TraceData* info, MicroProfilerThreadSnapshot& thread) {
+  thread.threadId = info->threadId_;
+  thread.threadIndex = info->threadIndex_;
+  for (uint32_t i = 0; i < profiling.sectionNames_.size(); i++) {
+    auto data = info->sections_[i].load(std::memory_order_acquire);
+    if (data == nullptr || data->calls_ == 0) {
+      continue;
+    }
+    MicroProfilerSectionStats section;
+    section.name = i;
+    section.calls = data->calls_;
+    section.totalNs = data->totalNs_;
+    section.minNs = data->minNs_;
+    section.maxNs = data->maxNs_;
+    section.histogram.reserve(kMicroProfilerHistogramBuckets);
+    for (auto& count : data->histogram_) {
+      section.histogram.push_back(static_cast<uint32_t>(count.load()));
+    }
+    thread.sections.push_back(std::move(section));
+  }
+  auto eventCount = info->eventCount_.load(std::memory_order_acquire);
+  thread.events.assign(info->events_.get(), info->events_.get() + eventCount);
+  thread.droppedEvents = info->droppedEvents_;
+  return !thread.sections.empty() || !thread.events.empty();
+}
+
+// Expects the mutex to be held.
+static MicroProfilerSnapshot takeSnapshot() {
+  MicroProfilerSnapshot snapshot;
+  snapshot.startTimeNs = profiling.startTime_;
+  snapshot.endTimeNs = profiling.isProfiling_ ? nowNs() : profiling.endTime_;
+  snapshot.clockOverheadNs = profiling.clockOverhead_;
+  snapshot.profileSectionOverheadNs = profiling.profileSectionOverhead_;
+  snapshot.sectionNames.assign(profiling.sectionNames_.begin(), profiling.sectionNames_.end());
+  snapshot.threads = profiling.exitedThreads_;
+
+  for (auto info : profiling.allTraceData_) {
+    MicroProfilerThreadSnapshot thread;
+    if (snapshotThread(info, thread)) {
+      snapshot.threads.push_back(std::move(thread));
+    }
+  }
+  return snapshot;
+}
+
+static void printReport(const MicroProfilerSnapshot& snapshot) {
   LOG(ERROR) << "======= MICRO PROFILER REPORT =======";
-  LOG(ERROR) << "- Total Time: " << formatTimeNs(diffNs(profiling.startTime_, profiling.endTime_));
-  LOG(ERROR) << "- Clock Overhead: " << formatTimeNs(profiling.clockOverhead_);
-  LOG(ERROR) << "- Profiler Section Overhead: " << formatTimeNs(profiling.profileSectionOverhead_);
+  LOG(ERROR) << "- Total Time: " << formatTimeNs(diffNs(snapshot.startTimeNs, snapshot.endTimeNs));
+  LOG(ERROR) << "- Clock Overhead: " << formatTimeNs(snapshot.clockOverheadNs);
+  LOG(ERROR) << "- Profiler Section Overhead: " << formatTimeNs(snapshot.profileSectionOverheadNs);
+  for (const auto& thread : snapshot.threads) {
+    LOG(ERROR) << "--- Thread ID 0x" << std::hex << thread.threadId << " ---";
+    for (const auto& section : thread.sections) {
+      LOG(ERROR) << "- " << snapshot.sectionNames[section.name] << ": "
+          << formatTimeNs(section.totalNs) << " (" << std::dec << section.calls << " calls, "
+          << formatTimeNs(section.totalNs / section.calls) << "/call, p50 "
+          << formatTimeNs(section.percentileNs(0.5)) << ", p99 "
+          << formatTimeNs(section.percentileNs(0.99)) << ", max "
+          << formatTimeNs(section.maxNs) << ")";
+    }
+  }
+}
+
+// Expects the mutex to be held and profiling to be stopped. Waits for threads
+// which saw profiling running to finish recording their last section.
+static void waitForRecording() {
   for (auto info : profiling.allTraceData_) {
-    LOG(ERROR) << "--- Thread ID 0x" << std::hex << info->threadId_ << " ---";
-    for (int i = 0; i < MicroProfilerName::__LENGTH__; i++) {
-      if (info->times_[i] > 0) {
-        auto totalTime = info->times_[i].load();
-        auto calls = info->calls_[i].load();
-        auto clockOverhead = profiling.clockOverhead_ * calls + profiling.profileSectionOverhead_ * info->childProfileSections_[i].load();
-        if (totalTime < clockOverhead) {
-          LOG(ERROR) << "- " << MicroProfiler::profilingNameToString(static_cast<MicroProfilerName>(i)) << ": "
-              << "ERROR: Total time was " << totalTime << "ns but clock overhead was calculated to be " << clockOverhead << "ns!";
-        } else {
-          auto correctedTime = totalTime - clockOverhead;
-          auto timePerCall = correctedTime / calls;
-          LOG(ERROR) << "- " << MicroProfiler::profilingNameToString(static_cast<MicroProfilerName>(i)) << ": "
-              << formatTimeNs(correctedTime) << " (" << calls << " calls, " << formatTimeNs(timePerCall) << "/call)";
-        }
-      }
+    while (info->recording_.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
     }
   }
 }
 
 static void clearProfiling() {
   CHECK(!profiling.isProfiling_) << "Trying to clear profiling but profiling was already started!";
+  waitForRecording();
+  profiling.exitedThreads_.clear();
   for (auto info : profiling.allTraceData_) {
-    for (unsigned int i = 0; i < MicroProfilerName::__LENGTH__; i++) {
-      info->times_[i] = 0;
-      info->calls_[i] = 0;
-      info->childProfileSections_[i] = 0;
+    for (auto& section : info->sections_) {
+      auto data = section.load();
+      if (data == nullptr) {
+        continue;
+      }
+      data->calls_ = 0;
+      data->totalNs_ = 0;
+      data->minNs_ = std::numeric_limits<uint_fast64_t>::max();
+      data->maxNs_ = 0;
+      for (auto& count : data->histogram_) {
+        count = 0;
+      }
     }
+    info->resizeEvents(profiling.eventsPerThread_);
+    info->eventCount_ = 0;
+    info->droppedEvents_ = 0;
   }
 }
 
@@ -157,66 +437,98 @@ static uint_fast64_t calculateClockOverhead() {
 }
 
 static uint_fast64_t calculateProfileSectionOverhead() {
+  auto name = MicroProfiler::registerSection("__INTERNAL_SECTION_OVERHEAD");
   int numCalls = 1000000;
   uint_fast64_t start = nowNs();
   profiling.isProfiling_ = true;
   for (int i = 0; i < numCalls; i++) {
-    MICRO_PROFILER_SECTION(static_cast<MicroProfilerName>(0));
+    MicroProfilerSection section(name);
   }
   uint_fast64_t end = nowNs();
   profiling.isProfiling_ = false;
   return (end - start) / numCalls;
 }
 
-void MicroProfiler::startProfiling() {
+void MicroProfiler::startProfiling(uint32_t eventsPerThread) {
   CHECK(!profiling.isProfiling_) << "Trying to start profiling but profiling was already started!";
 
   profiling.clockOverhead_ = calculateClockOverhead();
-  profiling.profileSectionOverhead_ = calculateProfileSectionOverhead();
+  profiling.profileSectionOverhead_ = 0;
+  auto profileSectionOverhead = calculateProfileSectionOverhead();
 
   std::lock_guard<std::mutex> lock(profiling.mutex_);
+  profiling.eventsPerThread_ = eventsPerThread;
+  // Other threads record sections while the overhead is measured, and read it
+  // until clearing has waited for them.
   clearProfiling();
+  profiling.profileSectionOverhead_ = profileSectionOverhead;
 
   profiling.startTime_ = nowNs();
   profiling.isProfiling_ = true;
 }
 
-void MicroProfiler::stopProfiling() {
+MicroProfilerSnapshot MicroProfiler::stopProfiling() {
   CHECK(profiling.isProfiling_) << "Trying to stop profiling but profiling hasn't been started!";
 
   profiling.isProfiling_ = false;
   profiling.endTime_ = nowNs();
 
   std::lock_guard<std::mutex> lock(profiling.mutex_);
+  waitForRecording();
 
-  printReport();
+  auto snapshot = takeSnapshot();
+  printReport(snapshot);
 
   clearProfiling();
+  return snapshot;
 }
 
 bool MicroProfiler::isProfiling() {
   return profiling.isProfiling_;
 }
 
+MicroProfilerSnapshot MicroProfiler::snapshot() {
+  std::lock_guard<std::mutex> lock(profiling.mutex_);
+  return takeSnapshot();
+}
+
 void MicroProfiler::runInternalBenchmark() {
+  auto outerName = MicroProfiler::registerSection("__INTERNAL_BENCHMARK_OUTER");
+  auto innerName = MicroProfiler::registerSection("__INTERNAL_BENCHMARK_INNER");
   MicroProfiler::startProfiling();
   for (int i = 0; i < 1000000; i++) {
-    MICRO_PROFILER_SECTION_NAMED(outer, __INTERNAL_BENCHMARK_OUTER);
+    MicroProfilerSection outer(outerName);
     {
-      MICRO_PROFILER_SECTION_NAMED(inner, __INTERNAL_BENCHMARK_INNER);
+      MicroProfilerSection inner(innerName);
     }
   }
   MicroProfiler::stopProfiling();
 }
 #else
-void MicroProfiler::startProfiling() {
+MicroProfilerSection::MicroProfilerSection(MicroProfilerName name) :
+    isProfiling_(false),
+    name_(name) {
+}
+MicroProfilerSection::~MicroProfilerSection() {
+}
+MicroProfilerName MicroProfiler::registerSection(const std::string& name) {
+  return 0;
+}
+std::string MicroProfiler::profilingNameToString(MicroProfilerName name) {
+  return "";
+}
+void MicroProfiler::startProfiling(uint32_t eventsPerThread) {
   CHECK(false) << "This platform has a stub implementation of the micro profiler and cannot collect traces";
 }
-void MicroProfiler::stopProfiling() {
+MicroProfilerSnapshot MicroProfiler::stopProfiling() {
+  return MicroProfilerSnapshot();
 }
 bool MicroProfiler::isProfiling() {
   return false;
 }
+MicroProfilerSnapshot MicroProfiler::snapshot() {
+  return MicroProfilerSnapshot();
+}
 void MicroProfiler::runInternalBenchmark() {
 }
 #endif
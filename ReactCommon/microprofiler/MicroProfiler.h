@@ -3,13 +3,18 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <string>
 #include <thread>
+#include <vector>
 
 // #define WITH_MICRO_PROFILER 1
 
 #ifdef WITH_MICRO_PROFILER
-#define MICRO_PROFILER_SECTION(name) MicroProfilerSection __b(name)
-#define MICRO_PROFILER_SECTION_NAMED(var_name, name) MicroProfilerSection var_name(name)
+#define MICRO_PROFILER_SECTION(name) MICRO_PROFILER_SECTION_NAMED(__b, name)
+#define MICRO_PROFILER_SECTION_NAMED(var_name, name) \
+  static const MicroProfilerName var_name##Name = MicroProfiler::registerSection(name); \
+  MicroProfilerSection var_name(var_name##Name)
 #else
 #define MICRO_PROFILER_SECTION(name)
 #define MICRO_PROFILER_SECTION_NAMED(var_name, name)
@@ -18,10 +23,67 @@
 namespace facebook {
 namespace react {
 
-enum MicroProfilerName {
-  __INTERNAL_BENCHMARK_INNER,
-  __INTERNAL_BENCHMARK_OUTER,
-  __LENGTH__,
+/**
+ * Identifies a profiled section, as returned by MicroProfiler::registerSection.
+ */
+using MicroProfilerName = uint32_t;
+
+const uint32_t kMicroProfilerMaxSections = 512;
+
+/**
+ * Section times are counted in log-linear buckets: one per nanosecond below 8ns, then 8 per
+ * power of two, so that a bucket's bounds are within 12.5% of each other.
+ */
+const uint32_t kMicroProfilerHistogramSubBuckets = 8;
+const uint32_t kMicroProfilerHistogramBuckets = 62 * kMicroProfilerHistogramSubBuckets;
+
+struct MicroProfilerSectionStats {
+  MicroProfilerName name;
+  uint64_t calls;
+  uint64_t totalNs;
+  uint64_t minNs;
+  uint64_t maxNs;
+  // Calls per bucket, see MicroProfiler::histogramBucketLowerBoundNs.
+  std::vector<uint32_t> histogram;
+
+  // Upper bound of the bucket holding the given fraction of the calls, 0.5 for the median.
+  uint64_t percentileNs(double fraction) const;
+};
+
+/**
+ * A single section call, recorded if profiling was started with room for events.
+ */
+struct MicroProfilerEvent {
+  MicroProfilerName name;
+  // Since MicroProfilerSnapshot::startTimeNs.
+  uint64_t startNs;
+  uint64_t durationNs;
+};
+
+struct MicroProfilerThreadSnapshot {
+  std::thread::id threadId;
+  // Small number identifying the thread within the process, for trace viewers.
+  uint32_t threadIndex;
+  std::vector<MicroProfilerSectionStats> sections;
+  std::vector<MicroProfilerEvent> events;
+  uint64_t droppedEvents;
+};
+
+struct MicroProfilerSnapshot {
+  uint64_t startTimeNs;
+  uint64_t endTimeNs;
+  uint64_t clockOverheadNs;
+  uint64_t profileSectionOverheadNs;
+  // Indexed by MicroProfilerName.
+  std::vector<std::string> sectionNames;
+  std::vector<MicroProfilerThreadSnapshot> threads;
+
+  /**
+   * Chrome trace event JSON, which chrome://tracing and Perfetto open. Recorded events show up
+   * as slices on their thread's track; the statistics of each section are listed under
+   * "microProfilerSections" in the trace's otherData.
+   */
+  std::string toChromeTraceJson() const;
 };
 
 /**
@@ -39,28 +101,32 @@ enum MicroProfilerName {
  * average cost of profiling a no-op code section, as well as invoking the average
  * cost of invoking the system clock. The former is subtracted out for each child
  * profiler section that is invoked within a parent profiler section. The latter is
- * subtracted from each section, child or not.
+ * subtracted from each section, child or not. Each corrected call time goes into a
+ * histogram kept per section and per thread.
  *
  * After MicroProfiler::stopProfiling() is called, a table of tracing data is emitted
- * to glog (which shows up in logcat on Android).
+ * to glog (which shows up in logcat on Android), and returned as a snapshot.
  */
 struct MicroProfiler {
-  static const char* profilingNameToString(MicroProfilerName name) {
-    switch (name) {
-      case __INTERNAL_BENCHMARK_INNER:
-        return "__INTERNAL_BENCHMARK_INNER";
-      case __INTERNAL_BENCHMARK_OUTER:
-        return "__INTERNAL_BENCHMARK_OUTER";
-      case __LENGTH__:
-        throw std::runtime_error("__LENGTH__ has no name");
-      default:
-        throw std::runtime_error("Trying to convert unknown MicroProfilerName to string");
-    }
-  }
-
-  static void startProfiling();
-  static void stopProfiling();
+  /**
+   * Returns the section with the given name, adding it the first time. Meant to be called
+   * once per call site, as MICRO_PROFILER_SECTION does.
+   */
+  static MicroProfilerName registerSection(const std::string& name);
+  static std::string profilingNameToString(MicroProfilerName name);
+  // The histogram bucket counting calls that took timeNs.
+  static uint32_t histogramBucket(uint64_t timeNs);
+  static uint64_t histogramBucketLowerBoundNs(uint32_t bucket);
+
+  /**
+   * Each thread additionally records its first eventsPerThread section calls, to be exported
+   * as a timeline.
+   */
+  static void startProfiling(uint32_t eventsPerThread = 0);
+  static MicroProfilerSnapshot stopProfiling();
   static bool isProfiling();
+  // Data collected so far, which can be taken while profiling.
+  static MicroProfilerSnapshot snapshot();
   static void runInternalBenchmark();
 };
 
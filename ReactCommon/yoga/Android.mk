@@ -6,8 +6,12 @@ LOCAL_MODULE := yogacore
 
 LOCAL_SRC_FILES := \
   yoga/Yoga.c \
+  yoga/YGClock.c \
   yoga/YGEnums.c \
-  yoga/YGNodeList.c
+  yoga/YGMeasureCache.c \
+  yoga/YGNodeList.c \
+  yoga/YGSlab.c \
+  yoga/YGThreadPool.c
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_C_INCLUDES)
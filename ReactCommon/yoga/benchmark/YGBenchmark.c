@@ -0,0 +1,587 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <yoga/Yoga.h>
+
+#define NUM_REPETITIONS 100
+
+// Wall clock time, so that work spread over several threads is not counted
+// once per thread.
+static double __nowInMs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+#define YGBENCHMARKS(BLOCK)                   \
+  int main(int argc, char const *argv[]) {    \
+    double __startTimes[NUM_REPETITIONS];     \
+    double __endTimes[NUM_REPETITIONS];       \
+    { BLOCK }                                 \
+    return 0;                                 \
+  }
+
+#define YGBENCHMARK(NAME, BLOCK) YGBENCHMARK_WITH_SETUP(NAME, {}, BLOCK, {})
+
+// Only BLOCK is timed. SETUP and TEARDOWN run around it on every repetition.
+#define YGBENCHMARK_WITH_SETUP(NAME, SETUP, BLOCK, TEARDOWN) \
+  for (uint32_t __i = 0; __i < NUM_REPETITIONS; __i++) {     \
+    { SETUP }                                                \
+    __startTimes[__i] = __nowInMs();                         \
+    { BLOCK }                                                \
+    __endTimes[__i] = __nowInMs();                           \
+    { TEARDOWN }                                             \
+  }                                                          \
+  __printBenchmarkResult(NAME, __startTimes, __endTimes);
+
+static int __compareDoubles(const void *a, const void *b) {
+  const double arg1 = *(const double *) a;
+  const double arg2 = *(const double *) b;
+  return (arg1 > arg2) - (arg1 < arg2);
+}
+
+static void __printBenchmarkResult(const char *name, double *startTimes, double *endTimes) {
+  double timesInMs[NUM_REPETITIONS];
+  double mean = 0;
+  for (uint32_t i = 0; i < NUM_REPETITIONS; i++) {
+    timesInMs[i] = endTimes[i] - startTimes[i];
+    mean += timesInMs[i];
+  }
+  mean /= NUM_REPETITIONS;
+
+  qsort(timesInMs, NUM_REPETITIONS, sizeof(double), __compareDoubles);
+  const double median = timesInMs[NUM_REPETITIONS / 2];
+
+  double variance = 0;
+  for (uint32_t i = 0; i < NUM_REPETITIONS; i++) {
+    variance += pow(timesInMs[i] - mean, 2);
+  }
+  variance /= NUM_REPETITIONS;
+  const double stddev = sqrt(variance);
+
+  printf("%s: median: %lf ms, stddev: %lf ms\n", name, median, stddev);
+}
+
+// Counts the bytes Yoga has allocated, to report memory per node. Every
+// allocation is prefixed with its size.
+#define ALLOCATION_HEADER 16
+
+static size_t gAllocatedBytes;
+static size_t gPeakAllocatedBytes;
+
+static void __trackAllocation(const size_t size) {
+  const size_t allocated = __atomic_add_fetch(&gAllocatedBytes, size, __ATOMIC_RELAXED);
+  size_t peak = __atomic_load_n(&gPeakAllocatedBytes, __ATOMIC_RELAXED);
+  while (allocated > peak &&
+         !__atomic_compare_exchange_n(
+             &gPeakAllocatedBytes, &peak, allocated, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+static void *__countingMalloc(size_t size) {
+  char *const block = malloc(size + ALLOCATION_HEADER);
+  if (!block) {
+    return NULL;
+  }
+  *(size_t *) block = size;
+  __trackAllocation(size);
+  return block + ALLOCATION_HEADER;
+}
+
+static void *__countingCalloc(size_t count, size_t size) {
+  void *const ptr = __countingMalloc(count * size);
+  if (ptr) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+static void __countingFree(void *ptr) {
+  if (ptr) {
+    char *const block = (char *) ptr - ALLOCATION_HEADER;
+    __atomic_sub_fetch(&gAllocatedBytes, *(size_t *) block, __ATOMIC_RELAXED);
+    free(block);
+  }
+}
+
+static void *__countingRealloc(void *ptr, size_t size) {
+  if (!ptr) {
+    return __countingMalloc(size);
+  }
+  char *const block = (char *) ptr - ALLOCATION_HEADER;
+  const size_t oldSize = *(size_t *) block;
+  char *const newBlock = realloc(block, size + ALLOCATION_HEADER);
+  if (!newBlock) {
+    return NULL;
+  }
+  *(size_t *) newBlock = size;
+  __atomic_sub_fetch(&gAllocatedBytes, oldSize, __ATOMIC_RELAXED);
+  __trackAllocation(size);
+  return newBlock + ALLOCATION_HEADER;
+}
+
+#define TREE_BREADTH 10
+
+// Three levels of TREE_BREADTH children each, i.e. ~1000 leaves.
+static YGNodeRef buildTree(const YGConfigRef config) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 1000);
+  YGNodeStyleSetHeight(root, 1000);
+  for (uint32_t i = 0; i < TREE_BREADTH; i++) {
+    const YGNodeRef child = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexGrow(child, 1);
+    YGNodeStyleSetFlexDirection(child, YGFlexDirectionRow);
+    YGNodeInsertChild(root, child, i);
+    for (uint32_t ii = 0; ii < TREE_BREADTH; ii++) {
+      const YGNodeRef grandChild = YGNodeNewWithConfig(config);
+      YGNodeStyleSetFlexGrow(grandChild, 1);
+      YGNodeInsertChild(child, grandChild, ii);
+      for (uint32_t iii = 0; iii < TREE_BREADTH; iii++) {
+        const YGNodeRef leaf = YGNodeNewWithConfig(config);
+        YGNodeStyleSetHeight(leaf, 10);
+        YGNodeStyleSetMargin(leaf, YGEdgeAll, 1);
+        YGNodeInsertChild(grandChild, leaf, iii);
+      }
+    }
+  }
+  return root;
+}
+
+#define LIST_CELL_COUNT 500
+#define LIST_CELL_CHILD_COUNT 20
+
+// A list of independently sized cells, the case parallel layout is meant for.
+static YGNodeRef buildList(const YGConfigRef config) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 400);
+  for (uint32_t i = 0; i < LIST_CELL_COUNT; i++) {
+    const YGNodeRef cell = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(cell, 400);
+    YGNodeStyleSetHeight(cell, 80);
+    YGNodeStyleSetFlexDirection(cell, YGFlexDirectionRow);
+    YGNodeStyleSetFlexWrap(cell, YGWrapWrap);
+    YGNodeInsertChild(root, cell, i);
+    for (uint32_t ii = 0; ii < LIST_CELL_CHILD_COUNT; ii++) {
+      const YGNodeRef child = YGNodeNewWithConfig(config);
+      YGNodeStyleSetFlexGrow(child, 1);
+      YGNodeStyleSetMinWidth(child, 40);
+      YGNodeStyleSetPadding(child, YGEdgeAll, 2);
+      YGNodeInsertChild(cell, child, ii);
+    }
+  }
+  return root;
+}
+
+// Dirties every cell so that each layout redoes all of them.
+static void touchList(const YGNodeRef root, const uint32_t iteration) {
+  for (uint32_t i = 0; i < LIST_CELL_COUNT; i++) {
+    const YGNodeRef child = YGNodeGetChild(YGNodeGetChild(root, i), 0);
+    YGNodeStyleSetMargin(child, YGEdgeLeft, iteration % 2);
+  }
+}
+
+#define CHAIN_DEPTH 200
+#define ROW_WIDTH 2000
+#define GRID_CELL_COUNT 1000
+#define OVERLAY_COUNT 200
+#define TEXT_ROW_COUNT 300
+
+static YGNodeRef buildDeepChain(const YGConfigRef config) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 400);
+  YGNodeRef parent = root;
+  for (uint32_t i = 0; i < CHAIN_DEPTH; i++) {
+    const YGNodeRef child = YGNodeNewWithConfig(config);
+    YGNodeStyleSetPadding(child, YGEdgeLeft, 1);
+    YGNodeStyleSetFlexDirection(child, i % 2 ? YGFlexDirectionRow : YGFlexDirectionColumn);
+    YGNodeInsertChild(parent, child, 0);
+    parent = child;
+  }
+  YGNodeStyleSetHeight(parent, 10);
+  return root;
+}
+
+static YGNodeRef buildWideRow(const YGConfigRef config) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 4000);
+  YGNodeStyleSetHeight(root, 100);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetAlignItems(root, YGAlignCenter);
+  for (uint32_t i = 0; i < ROW_WIDTH; i++) {
+    const YGNodeRef child = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexGrow(child, 1 + i % 3);
+    YGNodeStyleSetFlexShrink(child, 1);
+    YGNodeStyleSetFlexBasis(child, 2);
+    YGNodeStyleSetHeight(child, 10 + i % 20);
+    YGNodeInsertChild(root, child, i);
+  }
+  return root;
+}
+
+static YGNodeRef buildWrapGrid(const YGConfigRef config) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 400);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+  YGNodeStyleSetAlignContent(root, YGAlignFlexStart);
+  for (uint32_t i = 0; i < GRID_CELL_COUNT; i++) {
+    const YGNodeRef cell = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(cell, 30 + i % 5 * 10);
+    YGNodeStyleSetHeight(cell, 30 + i % 3 * 10);
+    YGNodeStyleSetMargin(cell, YGEdgeAll, 2);
+    YGNodeInsertChild(root, cell, i);
+  }
+  return root;
+}
+
+static YGNodeRef buildAbsoluteOverlays(const YGConfigRef config) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 400);
+  for (uint32_t i = 0; i < OVERLAY_COUNT; i++) {
+    const YGNodeRef container = YGNodeNewWithConfig(config);
+    YGNodeStyleSetHeight(container, 60);
+    YGNodeInsertChild(root, container, i);
+    for (uint32_t ii = 0; ii < 4; ii++) {
+      const YGNodeRef overlay = YGNodeNewWithConfig(config);
+      YGNodeStyleSetPositionType(overlay, YGPositionTypeAbsolute);
+      YGNodeStyleSetPositionPercent(overlay, YGEdgeLeft, 5 * ii);
+      YGNodeStyleSetPositionPercent(overlay, YGEdgeTop, 10);
+      YGNodeStyleSetWidthPercent(overlay, 50);
+      YGNodeStyleSetAspectRatio(overlay, 1 + ii);
+      YGNodeInsertChild(container, overlay, ii);
+    }
+  }
+  return root;
+}
+
+// Stands in for text layout: the cost grows with the length of the text,
+// which is kept in the node's context.
+static YGSize measureText(YGNodeRef node,
+                          float width,
+                          YGMeasureMode widthMode,
+                          float height,
+                          YGMeasureMode heightMode) {
+  const uint32_t length = (uint32_t)(uintptr_t) YGNodeGetContext(node);
+  volatile uint32_t hash = 0;
+  for (uint32_t i = 0; i < length * 50; i++) {
+    hash = hash * 31 + i;
+  }
+
+  const float textWidth = 7.0f * length;
+  const float lineWidth =
+      widthMode == YGMeasureModeUndefined || textWidth < width ? textWidth : width;
+  const float lines = lineWidth > 0 ? ceilf(textWidth / lineWidth) : 1;
+  return (YGSize){.width = lineWidth, .height = 16.0f * lines};
+}
+
+static YGNodeRef buildTextRows(const YGConfigRef config) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 360);
+  for (uint32_t i = 0; i < TEXT_ROW_COUNT; i++) {
+    const YGNodeRef row = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetPadding(row, YGEdgeAll, 8);
+    YGNodeInsertChild(root, row, i);
+    for (uint32_t ii = 0; ii < 3; ii++) {
+      // A handful of distinct labels, repeated from row to row.
+      const uint32_t length = 4 + (i % 5) * 6 + ii * 3;
+      const YGNodeRef text = YGNodeNewWithConfig(config);
+      YGNodeSetContext(text, (void *)(uintptr_t) length);
+      YGNodeSetMeasureFunc(text, measureText);
+      YGNodeSetMeasureCacheKey(text, length);
+      YGNodeStyleSetFlexShrink(text, 1);
+      YGNodeStyleSetMargin(text, YGEdgeRight, 4);
+      YGNodeInsertChild(row, text, ii);
+    }
+  }
+  return root;
+}
+
+typedef struct YGBenchmarkTree {
+  const char *name;
+  YGNodeRef root;
+} YGBenchmarkTree;
+
+typedef YGNodeRef (*YGBenchmarkTreeBuilder)(const YGConfigRef config);
+
+static uint32_t countNodes(const YGNodeRef node) {
+  uint32_t count = 1;
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    count += countNodes(YGNodeGetChild(node, i));
+  }
+  return count;
+}
+
+static uint32_t gMeasureCalls;
+
+static YGSize countingMeasureText(YGNodeRef node,
+                                  float width,
+                                  YGMeasureMode widthMode,
+                                  float height,
+                                  YGMeasureMode heightMode) {
+  gMeasureCalls++;
+  return measureText(node, width, widthMode, height, heightMode);
+}
+
+static uint32_t countMeasuredLeaves(const YGNodeRef node, const bool countCalls) {
+  if (YGNodeGetMeasureFunc(node)) {
+    if (countCalls && YGNodeGetMeasureFunc(node) == measureText) {
+      YGNodeSetMeasureFunc(node, countingMeasureText);
+    }
+    return 1;
+  }
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    count += countMeasuredLeaves(YGNodeGetChild(node, i), countCalls);
+  }
+  return count;
+}
+
+// Trees captured from apps with YGNodeSerialize, given on the command line.
+// The snapshot is rebuilt without its layout for every repetition, while the
+// recorded tree keeps it, to answer measure calls with the sizes the app's own
+// measure functions returned.
+static void *gSnapshot;
+static size_t gSnapshotSize;
+static YGConfigRef gSnapshotConfig;
+static YGNodeRef gRecordedTree;
+
+static YGSize replayMeasure(YGNodeRef node,
+                            float width,
+                            YGMeasureMode widthMode,
+                            float height,
+                            YGMeasureMode heightMode) {
+  gMeasureCalls++;
+  const YGNodeRef recorded = YGNodeGetContext(node);
+  const float recordedWidth = YGNodeLayoutGetWidth(recorded);
+  const float recordedHeight = YGNodeLayoutGetHeight(recorded);
+  return (YGSize){
+      .width = YGFloatIsUndefined(recordedWidth) ? 0 : recordedWidth,
+      .height = YGFloatIsUndefined(recordedHeight) ? 0 : recordedHeight,
+  };
+}
+
+static void linkRecordedLeaves(const YGNodeRef node, const YGNodeRef recorded) {
+  if (YGNodeGetMeasureFunc(node)) {
+    YGNodeSetContext(node, recorded);
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    linkRecordedLeaves(YGNodeGetChild(node, i), YGNodeGetChild(recorded, i));
+  }
+}
+
+static YGNodeRef buildSnapshotTree(const YGConfigRef config) {
+  YGConfigCopy(config, gSnapshotConfig);
+  const YGNodeRef root = YGNodeDeserialize(gSnapshot, gSnapshotSize, config, replayMeasure);
+  linkRecordedLeaves(root, gRecordedTree);
+  return root;
+}
+
+static bool loadSnapshot(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "%s: could not open snapshot\n", path);
+    return false;
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  void *data = malloc(size > 0 ? size : 1);
+  const bool read = size > 0 && fread(data, 1, size, file) == (size_t) size;
+  fclose(file);
+
+  gSnapshotConfig = read ? YGConfigNewFromSnapshot(data, size) : NULL;
+  if (!gSnapshotConfig) {
+    fprintf(stderr, "%s: not a Yoga snapshot\n", path);
+    free(data);
+    return false;
+  }
+  gRecordedTree = YGNodeDeserialize(data, size, gSnapshotConfig, replayMeasure);
+  free(data);
+  if (!gRecordedTree) {
+    YGConfigFree(gSnapshotConfig);
+    return false;
+  }
+
+  gSnapshotSize = YGNodeSerialize(gRecordedTree, false, NULL, 0);
+  gSnapshot = malloc(gSnapshotSize);
+  YGNodeSerialize(gRecordedTree, false, gSnapshot, gSnapshotSize);
+  return true;
+}
+
+static void unloadSnapshot(void) {
+  free(gSnapshot);
+  YGNodeFreeRecursive(gRecordedTree);
+  YGConfigFree(gSnapshotConfig);
+}
+
+// The last node in the tree, usually the deepest.
+static YGNodeRef lastLeaf(YGNodeRef node) {
+  while (YGNodeGetChildCount(node) > 0) {
+    node = YGNodeGetChild(node, YGNodeGetChildCount(node) - 1);
+  }
+  return node;
+}
+
+static void dirtyLeaf(const YGNodeRef leaf, const uint32_t iteration) {
+  if (YGNodeGetMeasureFunc(leaf)) {
+    YGNodeMarkDirty(leaf);
+  } else {
+    YGNodeStyleSetMargin(leaf, YGEdgeLeft, iteration % 2);
+  }
+}
+
+static YGLayoutStats gLayoutStats;
+
+static void recordLayoutStats(const YGNodeRef root, const YGLayoutStats *const stats) {
+  gLayoutStats = *stats;
+}
+
+// Prints size and cache figures for a tree, which the timings alone don't show.
+static void printTreeStats(const char *name, const YGBenchmarkTreeBuilder build) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetMeasureCacheCapacity(config, 256);
+  YGConfigSetLayoutStatsFunc(config, recordLayoutStats);
+
+  const size_t allocatedBefore = gAllocatedBytes;
+  gPeakAllocatedBytes = allocatedBefore;
+  const YGNodeRef root = build(config);
+  const uint32_t nodeCount = countNodes(root);
+  const uint32_t measuredLeaves = countMeasuredLeaves(root, true);
+
+  gMeasureCalls = 0;
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  const uint32_t layoutMeasureCalls = gMeasureCalls;
+  const size_t peakBytes = gPeakAllocatedBytes - allocatedBefore;
+
+  gMeasureCalls = 0;
+  dirtyLeaf(lastLeaf(root), 1);
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  const uint32_t relayoutMeasureCalls = gMeasureCalls;
+
+  uint64_t cachedHits = gLayoutStats.cachedLayoutHits;
+  for (uint32_t i = 0; i < YG_MAX_CACHED_RESULT_COUNT; i++) {
+    cachedHits += gLayoutStats.cachedMeasurementHits[i];
+  }
+
+  printf("%s: %u nodes, peak %.0f bytes/node", name, nodeCount, (double) peakBytes / nodeCount);
+  printf(", relayout visits %llu nodes, %.1f%% from node caches",
+         (unsigned long long) gLayoutStats.nodesVisited,
+         100.0 * cachedHits / gLayoutStats.nodesVisited);
+  if (measuredLeaves > 0) {
+    const YGMeasureCacheStats stats = YGConfigGetMeasureCacheStats(config);
+    printf(", %u measured leaves, with a measure cache: %u measure calls on layout"
+           ", %u on relayout",
+           measuredLeaves,
+           layoutMeasureCalls,
+           relayoutMeasureCalls);
+    // Only leaves with a measure cache key use the cache.
+    if (stats.hits + stats.misses > 0) {
+      printf(", %.1f%% cache hits", 100.0 * stats.hits / (stats.hits + stats.misses));
+    }
+  }
+  printf("\n");
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+static void benchmarkTree(const char *name,
+                          const YGBenchmarkTreeBuilder build,
+                          double *__startTimes,
+                          double *__endTimes) {
+  const YGConfigRef config = YGConfigNew();
+  char benchmarkName[128];
+  YGNodeRef root = NULL;
+
+  snprintf(benchmarkName, sizeof(benchmarkName), "%s: layout", name);
+  YGBENCHMARK_WITH_SETUP(benchmarkName, { root = build(config); }, {
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  }, { YGNodeFreeRecursive(root); });
+
+  root = build(config);
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  const YGNodeRef leaf = lastLeaf(root);
+  snprintf(benchmarkName, sizeof(benchmarkName), "%s: relayout after dirtying a leaf", name);
+  YGBENCHMARK(benchmarkName, {
+    dirtyLeaf(leaf, __i);
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  });
+  YGNodeFreeRecursive(root);
+
+  YGConfigFree(config);
+  printTreeStats(name, build);
+}
+
+YGBENCHMARKS({
+  YGSetMemoryFuncs(__countingMalloc, __countingCalloc, __countingRealloc, __countingFree);
+
+  benchmarkTree("Deep chain", buildDeepChain, __startTimes, __endTimes);
+  benchmarkTree("Wide row", buildWideRow, __startTimes, __endTimes);
+  benchmarkTree("Wrap grid", buildWrapGrid, __startTimes, __endTimes);
+  benchmarkTree("Absolute overlays", buildAbsoluteOverlays, __startTimes, __endTimes);
+  benchmarkTree("Text rows", buildTextRows, __startTimes, __endTimes);
+
+  for (int i = 1; i < argc; i++) {
+    if (loadSnapshot(argv[i])) {
+      benchmarkTree(argv[i], buildSnapshotTree, __startTimes, __endTimes);
+      unloadSnapshot();
+    }
+  }
+
+  const YGConfigRef heapConfig = YGConfigNew();
+  const YGConfigRef slabConfig = YGConfigNewWithSlabAllocator(256);
+
+  YGBENCHMARK("Build and free tree (heap)", {
+    YGNodeFreeRecursive(buildTree(heapConfig));
+  });
+
+  YGBENCHMARK("Build and free tree (slab)", {
+    YGNodeFreeRecursive(buildTree(slabConfig));
+  });
+
+  YGBENCHMARK("Build, layout and free tree (heap)", {
+    const YGNodeRef root = buildTree(heapConfig);
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    YGNodeFreeRecursive(root);
+  });
+
+  YGBENCHMARK("Build, layout and free tree (slab)", {
+    const YGNodeRef root = buildTree(slabConfig);
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    YGNodeFreeRecursive(root);
+  });
+
+  for (uint32_t threadCount = 1; threadCount <= 8; threadCount *= 2) {
+    const YGConfigRef listConfig = YGConfigNew();
+    YGConfigSetParallelLayout(listConfig, threadCount, false);
+    const YGNodeRef list = buildList(listConfig);
+
+    char name[64];
+    snprintf(name, sizeof(name), "Layout list of independent cells (%u threads)", threadCount);
+    YGBENCHMARK(name, {
+      touchList(list, __i);
+      YGNodeCalculateLayout(list, YGUndefined, YGUndefined, YGDirectionLTR);
+    });
+
+    YGNodeFreeRecursive(list);
+    YGConfigFree(listConfig);
+  }
+
+  YGConfigFree(heapConfig);
+  YGConfigFree(slabConfig);
+});
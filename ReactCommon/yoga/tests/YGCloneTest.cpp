@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <yoga/Yoga.h>
+
+#include <atomic>
+#include <thread>
+
+// root
+//   a (row)
+//     a0, a1
+//   b (row)
+//     b0, b1
+static YGNodeRef _newTree(const YGConfigRef config) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 100);
+  for (uint32_t i = 0; i < 2; i++) {
+    const YGNodeRef row = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetHeight(row, 10);
+    for (uint32_t j = 0; j < 2; j++) {
+      const YGNodeRef leaf = YGNodeNewWithConfig(config);
+      YGNodeStyleSetFlexGrow(leaf, 1);
+      YGNodeInsertChild(row, leaf, j);
+    }
+    YGNodeInsertChild(root, row, i);
+  }
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  return root;
+}
+
+TEST(YogaTest, clone_shares_children_until_they_are_cloned) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = _newTree(config);
+
+  const YGNodeRef clone = YGNodeClone(root);
+  ASSERT_EQ(YGNodeGetChild(root, 0), YGNodeGetChild(clone, 0));
+  ASSERT_EQ(YGNodeGetChild(root, 1), YGNodeGetChild(clone, 1));
+  ASSERT_FALSE(YGNodeIsDirty(clone));
+
+  const YGNodeRef a = YGNodeCloneChild(clone, 0);
+  ASSERT_NE(YGNodeGetChild(root, 0), a);
+  ASSERT_EQ(a, YGNodeGetChild(clone, 0));
+  ASSERT_EQ(clone, YGNodeGetParent(a));
+  ASSERT_EQ(root, YGNodeGetParent(YGNodeGetChild(root, 0)));
+  ASSERT_EQ(a, YGNodeCloneChild(clone, 0));
+
+  YGNodeFreeRecursive(clone);
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, clone_changes_only_dirty_the_clone) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = _newTree(config);
+
+  const YGNodeRef clone = YGNodeClone(root);
+  const YGNodeRef a = YGNodeCloneChild(clone, 0);
+  const YGNodeRef a1 = YGNodeCloneChild(a, 1);
+  YGNodeStyleSetFlexGrow(a1, 3);
+
+  ASSERT_TRUE(YGNodeIsDirty(a1));
+  ASSERT_TRUE(YGNodeIsDirty(a));
+  ASSERT_TRUE(YGNodeIsDirty(clone));
+  ASSERT_FALSE(YGNodeIsDirty(YGNodeGetChild(clone, 1)));
+
+  ASSERT_FALSE(YGNodeIsDirty(root));
+  ASSERT_FALSE(YGNodeIsDirty(YGNodeGetChild(root, 0)));
+  ASSERT_FALSE(YGNodeIsDirty(YGNodeGetChild(YGNodeGetChild(root, 0), 1)));
+
+  YGNodeFreeRecursive(clone);
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, clone_layout_leaves_original_layout_alone) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = _newTree(config);
+  const YGNodeRef b = YGNodeGetChild(root, 1);
+  const YGNodeRef b0 = YGNodeGetChild(b, 0);
+
+  const YGNodeRef clone = YGNodeClone(root);
+  const YGNodeRef a = YGNodeCloneChild(clone, 0);
+  YGNodeStyleSetFlexGrow(YGNodeCloneChild(a, 1), 3);
+  YGNodeCalculateLayout(clone, YGUndefined, YGUndefined, YGDirectionLTR);
+
+  ASSERT_FALSE(YGNodeIsDirty(clone));
+  ASSERT_FLOAT_EQ(25, YGNodeLayoutGetWidth(YGNodeGetChild(a, 0)));
+  ASSERT_FLOAT_EQ(75, YGNodeLayoutGetWidth(YGNodeGetChild(a, 1)));
+  ASSERT_FLOAT_EQ(50, YGNodeLayoutGetWidth(YGNodeGetChild(YGNodeGetChild(root, 0), 0)));
+  ASSERT_FLOAT_EQ(50, YGNodeLayoutGetWidth(YGNodeGetChild(YGNodeGetChild(root, 0), 1)));
+
+  // Subtrees that did not need layout again stay shared.
+  ASSERT_EQ(b0, YGNodeGetChild(YGNodeGetChild(clone, 1), 0));
+  ASSERT_EQ(b, YGNodeGetParent(b0));
+
+  YGNodeFreeRecursive(clone);
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, clone_adopts_children_of_freed_original) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = _newTree(config);
+
+  const YGNodeRef clone = YGNodeClone(root);
+  const YGNodeRef b = YGNodeGetChild(clone, 1);
+  YGNodeFreeRecursive(root);
+
+  ASSERT_EQ(nullptr, YGNodeGetParent(b));
+  ASSERT_EQ(b, YGNodeCloneChild(clone, 1));
+  ASSERT_EQ(clone, YGNodeGetParent(b));
+
+  YGNodeStyleSetHeight(b, 20);
+  ASSERT_TRUE(YGNodeIsDirty(b));
+  ASSERT_TRUE(YGNodeIsDirty(clone));
+  ASSERT_FALSE(YGNodeIsDirty(YGNodeGetChild(clone, 0)));
+
+  YGNodeCalculateLayout(clone, YGUndefined, YGUndefined, YGDirectionLTR);
+  ASSERT_FLOAT_EQ(30, YGNodeLayoutGetHeight(clone));
+
+  YGNodeFreeRecursive(clone);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, clone_measure_leaf_mark_dirty_reaches_clone_root) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = _newTree(config);
+  const YGNodeRef b1 = YGNodeGetChild(YGNodeGetChild(root, 1), 1);
+  YGNodeSetMeasureFunc(b1, [](YGNodeRef node, float width, YGMeasureMode widthMode,
+                              float height, YGMeasureMode heightMode) {
+    return YGSize{10, 10};
+  });
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+
+  const YGNodeRef clone = YGNodeClone(root);
+  const YGNodeRef leaf = YGNodeCloneChild(YGNodeCloneChild(clone, 1), 1);
+  YGNodeMarkDirty(leaf);
+
+  ASSERT_TRUE(YGNodeIsDirty(YGNodeGetChild(clone, 1)));
+  ASSERT_TRUE(YGNodeIsDirty(clone));
+  ASSERT_FALSE(YGNodeIsDirty(b1));
+  ASSERT_FALSE(YGNodeIsDirty(root));
+
+  YGNodeFreeRecursive(clone);
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+// The original may be read while its clone is laid out on another thread.
+TEST(YogaTest, clone_layout_while_original_is_read) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = _newTree(config);
+
+  std::atomic<bool> done(false);
+  std::thread reader([&]() {
+    while (!done) {
+      for (uint32_t i = 0; i < 2; i++) {
+        const YGNodeRef row = YGNodeGetChild(root, i);
+        for (uint32_t j = 0; j < 2; j++) {
+          ASSERT_FLOAT_EQ(50, YGNodeLayoutGetWidth(YGNodeGetChild(row, j)));
+        }
+      }
+    }
+  });
+
+  for (uint32_t pass = 0; pass < 100; pass++) {
+    const YGNodeRef clone = YGNodeClone(root);
+    YGNodeStyleSetFlexGrow(YGNodeCloneChild(YGNodeCloneChild(clone, pass % 2), 1), 1 + pass % 3);
+    YGNodeCalculateLayout(clone, YGUndefined, YGUndefined, YGDirectionLTR);
+    YGNodeFreeRecursive(clone);
+  }
+  done = true;
+  reader.join();
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
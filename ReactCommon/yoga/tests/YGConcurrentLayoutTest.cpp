@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <yoga/Yoga.h>
+
+#include <math.h>
+
+#include <thread>
+#include <vector>
+
+// Lays out separate trees on several threads at once, and checks that every
+// pass gives the same layout as a sequential one. Build with
+// -fsanitize=thread to also check for data races.
+
+static const uint32_t kThreadCount = 6;
+static const uint32_t kPassCount = 50;
+
+static YGSize _measureText(YGNodeRef node,
+                           float width,
+                           YGMeasureMode widthMode,
+                           float height,
+                           YGMeasureMode heightMode) {
+  const float textWidth = 10 * (float) (uintptr_t) YGNodeGetContext(node);
+  return YGSize{
+      widthMode == YGMeasureModeUndefined ? textWidth : fminf(width, textWidth),
+      heightMode == YGMeasureModeExactly ? height : 20,
+  };
+}
+
+// A list of fixed size cells, which parallel layout hands to other threads,
+// each holding a row of flexible children and a text leaf.
+static YGNodeRef _newTree(const YGConfigRef config, const uint32_t seed) {
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 400 + seed);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionColumn);
+
+  for (uint32_t i = 0; i < 20; i++) {
+    const YGNodeRef cell = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(cell, 300 + i);
+    YGNodeStyleSetHeight(cell, 40 + seed);
+    YGNodeStyleSetFlexDirection(cell, YGFlexDirectionRow);
+    YGNodeStyleSetPadding(cell, YGEdgeAll, (float) (i % 4));
+
+    for (uint32_t j = 0; j < 4; j++) {
+      const YGNodeRef child = YGNodeNewWithConfig(config);
+      YGNodeStyleSetFlexGrow(child, (float) (j + 1));
+      YGNodeStyleSetMargin(child, YGEdgeStart, (float) j);
+      YGNodeInsertChild(cell, child, j);
+    }
+
+    const YGNodeRef text = YGNodeNewWithConfig(config);
+    YGNodeSetContext(text, (void *) (uintptr_t) (i + seed + 1));
+    YGNodeSetMeasureFunc(text, _measureText);
+    YGNodeInsertChild(cell, text, 4);
+
+    YGNodeInsertChild(root, cell, i);
+  }
+  return root;
+}
+
+// Changes the tree differently on every pass, so that each one lays it out
+// again rather than hitting the cache.
+static void _changeTree(const YGNodeRef root, const uint32_t pass) {
+  YGNodeStyleSetWidth(root, 400 + (float) (pass % 7) * 10);
+  const YGNodeRef cell = YGNodeGetChild(root, pass % YGNodeGetChildCount(root));
+  YGNodeStyleSetWidth(cell, 250 + (float) (pass % 5) * 20);
+}
+
+static void _collectLayout(const YGNodeRef node, std::vector<float> *const layout) {
+  layout->push_back(YGNodeLayoutGetLeft(node));
+  layout->push_back(YGNodeLayoutGetTop(node));
+  layout->push_back(YGNodeLayoutGetWidth(node));
+  layout->push_back(YGNodeLayoutGetHeight(node));
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    _collectLayout(YGNodeGetChild(node, i), layout);
+  }
+}
+
+// Expected layout of every pass of tree seed, computed on one thread with
+// sequential layout.
+static std::vector<std::vector<float>> _sequentialLayouts(const uint32_t seed) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = _newTree(config, seed);
+  std::vector<std::vector<float>> layouts(kPassCount);
+  for (uint32_t pass = 0; pass < kPassCount; pass++) {
+    _changeTree(root, pass);
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+    _collectLayout(root, &layouts[pass]);
+  }
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+  return layouts;
+}
+
+// Lays out one tree per thread. Threads use their own config when
+// sharedConfig is NULL.
+static void _runConcurrently(const YGConfigRef sharedConfig) {
+  std::vector<std::vector<std::vector<float>>> expected;
+  for (uint32_t seed = 0; seed < kThreadCount; seed++) {
+    expected.push_back(_sequentialLayouts(seed));
+  }
+
+  std::vector<uint32_t> mismatches(kThreadCount);
+  std::vector<std::thread> threads;
+  for (uint32_t seed = 0; seed < kThreadCount; seed++) {
+    threads.emplace_back([&, seed]() {
+      const YGConfigRef config = sharedConfig ? sharedConfig : YGConfigNew();
+      const YGNodeRef root = _newTree(config, seed);
+      for (uint32_t pass = 0; pass < kPassCount; pass++) {
+        _changeTree(root, pass);
+        YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+        std::vector<float> layout;
+        _collectLayout(root, &layout);
+        if (layout != expected[seed][pass]) {
+          mismatches[seed]++;
+        }
+      }
+      YGNodeFreeRecursive(root);
+      if (!sharedConfig) {
+        YGConfigFree(config);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (uint32_t seed = 0; seed < kThreadCount; seed++) {
+    ASSERT_EQ(0u, mismatches[seed]) << "tree " << seed;
+  }
+}
+
+TEST(YogaTest, concurrent_layout_of_separate_trees) {
+  _runConcurrently(NULL);
+}
+
+TEST(YogaTest, concurrent_layout_of_separate_trees_sharing_parallel_config) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetParallelLayout(config, 4, false);
+
+  _runConcurrently(config);
+
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, concurrent_layout_of_separate_trees_measuring_on_calling_thread) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetParallelLayout(config, 3, true);
+
+  _runConcurrently(config);
+
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, concurrent_layout_of_separate_trees_sharing_slab_config) {
+  const YGConfigRef config = YGConfigNewWithSlabAllocator(16);
+
+  _runConcurrently(config);
+
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, concurrent_layout_of_cloned_trees_sharing_parallel_slab_config) {
+  const YGConfigRef config = YGConfigNewWithSlabAllocator(16);
+  YGConfigSetParallelLayout(config, 4, false);
+
+  // Each thread lays out a new version of its own tree on every pass, which
+  // copies the shared nodes it writes to on the layout threads.
+  std::vector<std::thread> threads;
+  for (uint32_t seed = 0; seed < kThreadCount; seed++) {
+    threads.emplace_back([config, seed]() {
+      YGNodeRef root = _newTree(config, seed);
+      YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+      for (uint32_t pass = 0; pass < kPassCount; pass++) {
+        const YGNodeRef clone = YGNodeClone(root);
+        YGNodeStyleSetWidth(clone, 400 + (float) (pass % 7) * 10);
+        YGNodeCalculateLayout(clone, YGUndefined, YGUndefined, YGDirectionLTR);
+        YGNodeFreeRecursive(root);
+        root = clone;
+      }
+      YGNodeFreeRecursive(root);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  YGConfigFree(config);
+}
@@ -0,0 +1,215 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <yoga/Yoga.h>
+
+#include <vector>
+
+// Snapshot header, then the root's flags, child count and style mask.
+static const size_t kHeaderSize = 21;
+static const size_t kRootStyleOffset = kHeaderSize + 1 + 4 + 4;
+
+static std::vector<uint8_t> _serialize(const YGNodeRef node, const bool includeLayout) {
+  std::vector<uint8_t> snapshot(YGNodeSerialize(node, includeLayout, NULL, 0));
+  YGNodeSerialize(node, includeLayout, snapshot.data(), snapshot.size());
+  return snapshot;
+}
+
+static int _silentLogger(const YGConfigRef config,
+                         const YGNodeRef node,
+                         YGLogLevel level,
+                         const char *format,
+                         va_list args) {
+  return 0;
+}
+
+static float _baseline(YGNodeRef node, const float width, const float height) {
+  return height / 2;
+}
+
+TEST(YogaTest, snapshot_round_trip_keeps_layout) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetWidth(root, 100);
+  const YGNodeRef child = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexGrow(child, 1);
+  YGNodeInsertChild(root, child, 0);
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+
+  const std::vector<uint8_t> snapshot = _serialize(root, true);
+  const YGNodeRef restored = YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL);
+  ASSERT_NE(nullptr, restored);
+  ASSERT_FALSE(YGNodeIsDirty(restored));
+  ASSERT_EQ(YGFlexDirectionRow, YGNodeStyleGetFlexDirection(restored));
+  ASSERT_FLOAT_EQ(100, YGNodeLayoutGetWidth(YGNodeGetChild(restored, 0)));
+
+  YGNodeFreeRecursive(restored);
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, snapshot_rejects_out_of_range_enums) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetLogger(config, _silentLogger);
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+
+  std::vector<uint8_t> snapshot = _serialize(root, false);
+  ASSERT_EQ(YGFlexDirectionRow, snapshot[kRootStyleOffset]);
+  snapshot[kRootStyleOffset] = 200;
+  ASSERT_EQ(nullptr, YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL));
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, snapshot_rejects_out_of_range_units) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetLogger(config, _silentLogger);
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 100);
+
+  std::vector<uint8_t> snapshot = _serialize(root, false);
+  // The width's value, then its unit.
+  ASSERT_EQ(YGUnitPoint, snapshot[kRootStyleOffset + 4]);
+  snapshot[kRootStyleOffset + 4] = YGUnitAuto + 1;
+  ASSERT_EQ(nullptr, YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL));
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, snapshot_rejects_non_finite_values_with_a_unit) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetLogger(config, _silentLogger);
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(root, 100);
+
+  // The high byte of the width's value turns it into a NaN.
+  std::vector<uint8_t> snapshot = _serialize(root, false);
+  snapshot[kRootStyleOffset + 3] = 0x7f;
+  ASSERT_EQ(nullptr, YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL));
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, snapshot_rejects_edges_with_a_unit_but_no_value) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetLogger(config, _silentLogger);
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetMargin(root, YGEdgeLeft, 10);
+
+  // Clears the margin's value mask, which follows its units.
+  std::vector<uint8_t> snapshot = _serialize(root, false);
+  ASSERT_EQ(kRootStyleOffset + 4 + 2 + 4, snapshot.size());
+  snapshot[kRootStyleOffset + 4] = 0;
+  snapshot[kRootStyleOffset + 5] = 0;
+  snapshot.resize(kRootStyleOffset + 6);
+  ASSERT_EQ(nullptr, YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL));
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+// Every snapshot with a single byte flipped either fails to load, or loads
+// into a tree that can be laid out.
+TEST(YogaTest, snapshot_with_flipped_bytes_loads_or_fails_cleanly) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetLogger(config, _silentLogger);
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetWidth(root, 100);
+  YGNodeStyleSetHeightPercent(root, 50);
+  YGNodeStyleSetPadding(root, YGEdgeAll, 4);
+  const YGNodeRef child = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexGrow(child, 1);
+  YGNodeStyleSetMarginPercent(child, YGEdgeTop, 10);
+  YGNodeStyleSetMarginAuto(child, YGEdgeLeft);
+  YGNodeInsertChild(root, child, 0);
+  YGNodeCalculateLayout(root, 200, 200, YGDirectionLTR);
+
+  const std::vector<uint8_t> original = _serialize(root, true);
+  const uint8_t flips[] = {0x01, 0x80, 0x7f, 0xff};
+  for (size_t i = 0; i < original.size(); i++) {
+    for (const uint8_t flip : flips) {
+      std::vector<uint8_t> snapshot = original;
+      snapshot[i] ^= flip;
+      const YGNodeRef restored = YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL);
+      if (restored != NULL) {
+        YGNodeCalculateLayout(restored, 200, 200, YGDirectionLTR);
+        YGNodeFreeRecursive(restored);
+      }
+    }
+  }
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, snapshot_rejects_unknown_node_flags) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetLogger(config, _silentLogger);
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+
+  std::vector<uint8_t> snapshot = _serialize(root, false);
+  snapshot[kHeaderSize] |= 0x80;
+  ASSERT_EQ(nullptr, YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL));
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, snapshot_rejects_deep_trees) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetLogger(config, _silentLogger);
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+
+  // A chain of nodes with one child each, far deeper than any real tree.
+  std::vector<uint8_t> snapshot = _serialize(root, false);
+  snapshot.resize(kHeaderSize);
+  const uint8_t node[] = {0, 1, 0, 0, 0, 0, 0, 0, 0};
+  for (uint32_t i = 0; i < 1000000; i++) {
+    snapshot.insert(snapshot.end(), node, node + sizeof(node));
+  }
+  ASSERT_EQ(nullptr, YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL));
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+TEST(YogaTest, snapshot_lays_out_nodes_which_lost_their_baseline_function_again) {
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetAlignItems(root, YGAlignBaseline);
+  const YGNodeRef row = YGNodeNewWithConfig(config);
+  const YGNodeRef leaf = YGNodeNewWithConfig(config);
+  YGNodeStyleSetHeight(leaf, 20);
+  YGNodeSetBaselineFunc(leaf, _baseline);
+  YGNodeInsertChild(row, leaf, 0);
+  YGNodeInsertChild(root, row, 0);
+  const YGNodeRef other = YGNodeNewWithConfig(config);
+  YGNodeInsertChild(root, other, 1);
+  YGNodeCalculateLayout(root, 100, 100, YGDirectionLTR);
+
+  const std::vector<uint8_t> snapshot = _serialize(root, true);
+  const YGNodeRef restored = YGNodeDeserialize(snapshot.data(), snapshot.size(), config, NULL);
+  ASSERT_NE(nullptr, restored);
+  ASSERT_TRUE(YGNodeIsDirty(YGNodeGetChild(YGNodeGetChild(restored, 0), 0)));
+  ASSERT_TRUE(YGNodeIsDirty(YGNodeGetChild(restored, 0)));
+  ASSERT_TRUE(YGNodeIsDirty(restored));
+  ASSERT_FALSE(YGNodeIsDirty(YGNodeGetChild(restored, 1)));
+
+  YGNodeFreeRecursive(restored);
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
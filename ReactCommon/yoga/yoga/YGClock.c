@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef _WIN32
+// clock_gettime is POSIX, which strict C99 leaves out.
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "YGClock.h"
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+double YGClockNowMs(void) {
+  static LARGE_INTEGER frequency;
+  if (frequency.QuadPart == 0) {
+    QueryPerformanceFrequency(&frequency);
+  }
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  return now.QuadPart * 1000.0 / frequency.QuadPart;
+}
+
+#else
+
+#include <time.h>
+
+double YGClockNowMs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+#endif
@@ -129,6 +129,36 @@ typedef YG_ENUM_BEGIN(YGPrintOptions) {
 } YG_ENUM_END(YGPrintOptions);
 WIN_EXPORT const char *YGPrintOptionsToString(const YGPrintOptions value);
 
+#define YGStylePropertyCount 25
+typedef YG_ENUM_BEGIN(YGStyleProperty) {
+  YGStylePropertyDirection,
+  YGStylePropertyFlexDirection,
+  YGStylePropertyJustifyContent,
+  YGStylePropertyAlignContent,
+  YGStylePropertyAlignItems,
+  YGStylePropertyAlignSelf,
+  YGStylePropertyPositionType,
+  YGStylePropertyFlexWrap,
+  YGStylePropertyOverflow,
+  YGStylePropertyDisplay,
+  YGStylePropertyFlex,
+  YGStylePropertyFlexGrow,
+  YGStylePropertyFlexShrink,
+  YGStylePropertyFlexBasis,
+  YGStylePropertyPosition,
+  YGStylePropertyMargin,
+  YGStylePropertyPadding,
+  YGStylePropertyBorder,
+  YGStylePropertyWidth,
+  YGStylePropertyHeight,
+  YGStylePropertyMinWidth,
+  YGStylePropertyMinHeight,
+  YGStylePropertyMaxWidth,
+  YGStylePropertyMaxHeight,
+  YGStylePropertyAspectRatio,
+} YG_ENUM_END(YGStyleProperty);
+WIN_EXPORT const char *YGStylePropertyToString(const YGStyleProperty value);
+
 #define YGUnitCount 4
 typedef YG_ENUM_BEGIN(YGUnit) {
   YGUnitUndefined,
@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <string.h>
+
+#include "YGMeasureCache.h"
+
+extern YGMalloc gYGMalloc;
+extern YGFree gYGFree;
+
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK YGMeasureCacheLock;
+#define YGMeasureCacheLockInit(lock) InitializeSRWLock(lock)
+#define YGMeasureCacheLockDestroy(lock)
+#define YGMeasureCacheLockAcquire(lock) AcquireSRWLockExclusive(lock)
+#define YGMeasureCacheLockRelease(lock) ReleaseSRWLockExclusive(lock)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t YGMeasureCacheLock;
+#define YGMeasureCacheLockInit(lock) pthread_mutex_init(lock, NULL)
+#define YGMeasureCacheLockDestroy(lock) pthread_mutex_destroy(lock)
+#define YGMeasureCacheLockAcquire(lock) pthread_mutex_lock(lock)
+#define YGMeasureCacheLockRelease(lock) pthread_mutex_unlock(lock)
+#endif
+
+#define YG_MEASURE_CACHE_NONE UINT32_MAX
+
+typedef struct YGMeasureCacheEntry {
+  YGMeasureFunc measure;
+  uint64_t key;
+  // Constraints as compared bit for bit, see YGMeasureCacheConstraintBits.
+  uint32_t width;
+  uint32_t height;
+  YGMeasureMode widthMode;
+  YGMeasureMode heightMode;
+  YGSize size;
+
+  uint32_t hash;
+  uint32_t nextInBucket;
+  // Neighbours in the recency list, most recently used first.
+  uint32_t newer;
+  uint32_t older;
+} YGMeasureCacheEntry;
+
+struct YGMeasureCache {
+  YGMeasureCacheLock lock;
+
+  uint32_t capacity;
+  uint32_t count;
+  YGMeasureCacheEntry *entries;
+  // Power of two number of buckets, each the index of its first entry.
+  uint32_t bucketMask;
+  uint32_t *buckets;
+  uint32_t newest;
+  uint32_t oldest;
+
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+};
+
+// The value a measure function is given along an undefined axis is
+// meaningless, and may be NaN, so all of them are treated as equal. So are
+// 0 and -0.
+static inline uint32_t YGMeasureCacheConstraintBits(const float value, const YGMeasureMode mode) {
+  if (mode == YGMeasureModeUndefined) {
+    return 0;
+  }
+  const float normalized = value + 0.0f;
+  uint32_t bits;
+  memcpy(&bits, &normalized, sizeof(bits));
+  return bits;
+}
+
+static inline uint32_t YGMeasureCacheHash(const YGMeasureFunc measure,
+                                          const uint64_t key,
+                                          const uint32_t width,
+                                          const YGMeasureMode widthMode,
+                                          const uint32_t height,
+                                          const YGMeasureMode heightMode) {
+  uint64_t hash = key ^ (uint64_t)(uintptr_t) measure;
+  hash = hash * 0x9E3779B97F4A7C15ull + (((uint64_t) width << 32) | height);
+  hash = hash * 0x9E3779B97F4A7C15ull + (((uint64_t) widthMode << 8) | heightMode);
+  hash ^= hash >> 31;
+  hash *= 0xBF58476D1CE4E5B9ull;
+  hash ^= hash >> 29;
+  return (uint32_t) hash;
+}
+
+YGMeasureCacheRef YGMeasureCacheNew(const uint32_t capacity) {
+  YGAssert(capacity > 0, "Measure cache must hold at least one entry");
+  const YGMeasureCacheRef cache = gYGMalloc(sizeof(struct YGMeasureCache));
+  YGAssert(cache != NULL, "Could not allocate memory for measure cache");
+
+  uint32_t bucketCount = 1;
+  while (bucketCount < capacity && bucketCount < (1u << 31)) {
+    bucketCount <<= 1;
+  }
+
+  YGMeasureCacheLockInit(&cache->lock);
+  cache->capacity = capacity;
+  cache->entries = gYGMalloc(sizeof(YGMeasureCacheEntry) * capacity);
+  cache->bucketMask = bucketCount - 1;
+  cache->buckets = gYGMalloc(sizeof(uint32_t) * bucketCount);
+  YGAssert(cache->entries != NULL && cache->buckets != NULL,
+           "Could not allocate memory for measure cache");
+  YGMeasureCacheClear(cache);
+  return cache;
+}
+
+void YGMeasureCacheFree(const YGMeasureCacheRef cache) {
+  if (!cache) {
+    return;
+  }
+  YGMeasureCacheLockDestroy(&cache->lock);
+  gYGFree(cache->buckets);
+  gYGFree(cache->entries);
+  gYGFree(cache);
+}
+
+void YGMeasureCacheClear(const YGMeasureCacheRef cache) {
+  YGMeasureCacheLockAcquire(&cache->lock);
+  for (uint32_t i = 0; i <= cache->bucketMask; i++) {
+    cache->buckets[i] = YG_MEASURE_CACHE_NONE;
+  }
+  cache->count = 0;
+  cache->newest = YG_MEASURE_CACHE_NONE;
+  cache->oldest = YG_MEASURE_CACHE_NONE;
+  cache->hits = 0;
+  cache->misses = 0;
+  cache->evictions = 0;
+  YGMeasureCacheLockRelease(&cache->lock);
+}
+
+YGMeasureCacheStats YGMeasureCacheGetStats(const YGMeasureCacheRef cache) {
+  YGMeasureCacheLockAcquire(&cache->lock);
+  const YGMeasureCacheStats stats = {
+      .hits = cache->hits,
+      .misses = cache->misses,
+      .evictions = cache->evictions,
+      .count = cache->count,
+      .capacity = cache->capacity,
+  };
+  YGMeasureCacheLockRelease(&cache->lock);
+  return stats;
+}
+
+static void YGMeasureCacheUnlinkRecency(const YGMeasureCacheRef cache, const uint32_t index) {
+  YGMeasureCacheEntry *const entry = &cache->entries[index];
+  if (entry->newer != YG_MEASURE_CACHE_NONE) {
+    cache->entries[entry->newer].older = entry->older;
+  } else {
+    cache->newest = entry->older;
+  }
+  if (entry->older != YG_MEASURE_CACHE_NONE) {
+    cache->entries[entry->older].newer = entry->newer;
+  } else {
+    cache->oldest = entry->newer;
+  }
+}
+
+static void YGMeasureCacheLinkNewest(const YGMeasureCacheRef cache, const uint32_t index) {
+  YGMeasureCacheEntry *const entry = &cache->entries[index];
+  entry->newer = YG_MEASURE_CACHE_NONE;
+  entry->older = cache->newest;
+  if (cache->newest != YG_MEASURE_CACHE_NONE) {
+    cache->entries[cache->newest].newer = index;
+  } else {
+    cache->oldest = index;
+  }
+  cache->newest = index;
+}
+
+static void YGMeasureCacheUnlinkBucket(const YGMeasureCacheRef cache, const uint32_t index) {
+  uint32_t *link = &cache->buckets[cache->entries[index].hash & cache->bucketMask];
+  while (*link != index) {
+    link = &cache->entries[*link].nextInBucket;
+  }
+  *link = cache->entries[index].nextInBucket;
+}
+
+static uint32_t YGMeasureCacheFind(const YGMeasureCacheRef cache,
+                                   const uint32_t hash,
+                                   const YGMeasureFunc measure,
+                                   const uint64_t key,
+                                   const uint32_t width,
+                                   const YGMeasureMode widthMode,
+                                   const uint32_t height,
+                                   const YGMeasureMode heightMode) {
+  for (uint32_t index = cache->buckets[hash & cache->bucketMask]; index != YG_MEASURE_CACHE_NONE;
+       index = cache->entries[index].nextInBucket) {
+    const YGMeasureCacheEntry *const entry = &cache->entries[index];
+    if (entry->hash == hash && entry->key == key && entry->measure == measure &&
+        entry->width == width && entry->height == height && entry->widthMode == widthMode &&
+        entry->heightMode == heightMode) {
+      return index;
+    }
+  }
+  return YG_MEASURE_CACHE_NONE;
+}
+
+bool YGMeasureCacheGet(const YGMeasureCacheRef cache,
+                       const YGMeasureFunc measure,
+                       const uint64_t key,
+                       const float width,
+                       const YGMeasureMode widthMode,
+                       const float height,
+                       const YGMeasureMode heightMode,
+                       YGSize *const size) {
+  const uint32_t widthBits = YGMeasureCacheConstraintBits(width, widthMode);
+  const uint32_t heightBits = YGMeasureCacheConstraintBits(height, heightMode);
+  const uint32_t hash =
+      YGMeasureCacheHash(measure, key, widthBits, widthMode, heightBits, heightMode);
+
+  YGMeasureCacheLockAcquire(&cache->lock);
+  const uint32_t index =
+      YGMeasureCacheFind(cache, hash, measure, key, widthBits, widthMode, heightBits, heightMode);
+  if (index == YG_MEASURE_CACHE_NONE) {
+    cache->misses++;
+    YGMeasureCacheLockRelease(&cache->lock);
+    return false;
+  }
+
+  cache->hits++;
+  if (cache->newest != index) {
+    YGMeasureCacheUnlinkRecency(cache, index);
+    YGMeasureCacheLinkNewest(cache, index);
+  }
+  *size = cache->entries[index].size;
+  YGMeasureCacheLockRelease(&cache->lock);
+  return true;
+}
+
+void YGMeasureCacheSet(const YGMeasureCacheRef cache,
+                       const YGMeasureFunc measure,
+                       const uint64_t key,
+                       const float width,
+                       const YGMeasureMode widthMode,
+                       const float height,
+                       const YGMeasureMode heightMode,
+                       const YGSize size) {
+  const uint32_t widthBits = YGMeasureCacheConstraintBits(width, widthMode);
+  const uint32_t heightBits = YGMeasureCacheConstraintBits(height, heightMode);
+  const uint32_t hash =
+      YGMeasureCacheHash(measure, key, widthBits, widthMode, heightBits, heightMode);
+
+  YGMeasureCacheLockAcquire(&cache->lock);
+  uint32_t index =
+      YGMeasureCacheFind(cache, hash, measure, key, widthBits, widthMode, heightBits, heightMode);
+  if (index != YG_MEASURE_CACHE_NONE) {
+    // Another thread measured the same content in the meantime.
+    YGMeasureCacheUnlinkRecency(cache, index);
+  } else {
+    if (cache->count < cache->capacity) {
+      index = cache->count++;
+    } else {
+      index = cache->oldest;
+      YGMeasureCacheUnlinkRecency(cache, index);
+      YGMeasureCacheUnlinkBucket(cache, index);
+      cache->evictions++;
+    }
+
+    YGMeasureCacheEntry *const entry = &cache->entries[index];
+    entry->measure = measure;
+    entry->key = key;
+    entry->width = widthBits;
+    entry->height = heightBits;
+    entry->widthMode = widthMode;
+    entry->heightMode = heightMode;
+    entry->hash = hash;
+
+    uint32_t *const bucket = &cache->buckets[hash & cache->bucketMask];
+    entry->nextInBucket = *bucket;
+    *bucket = index;
+  }
+
+  cache->entries[index].size = size;
+  YGMeasureCacheLinkNewest(cache, index);
+  YGMeasureCacheLockRelease(&cache->lock);
+}
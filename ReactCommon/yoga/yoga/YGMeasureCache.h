@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Yoga.h"
+
+YG_EXTERN_C_BEGIN
+
+// Bounded map from a measure function, a content key and the constraints it
+// was called with to the size it returned. Once full, the least recently used
+// entry is replaced. Safe to use from several threads at once.
+typedef struct YGMeasureCache *YGMeasureCacheRef;
+
+YGMeasureCacheRef YGMeasureCacheNew(const uint32_t capacity);
+void YGMeasureCacheFree(const YGMeasureCacheRef cache);
+void YGMeasureCacheClear(const YGMeasureCacheRef cache);
+YGMeasureCacheStats YGMeasureCacheGetStats(const YGMeasureCacheRef cache);
+
+bool YGMeasureCacheGet(const YGMeasureCacheRef cache,
+                       const YGMeasureFunc measure,
+                       const uint64_t key,
+                       const float width,
+                       const YGMeasureMode widthMode,
+                       const float height,
+                       const YGMeasureMode heightMode,
+                       YGSize *const size);
+void YGMeasureCacheSet(const YGMeasureCacheRef cache,
+                       const YGMeasureFunc measure,
+                       const uint64_t key,
+                       const float width,
+                       const YGMeasureMode widthMode,
+                       const float height,
+                       const YGMeasureMode heightMode,
+                       const YGSize size);
+
+YG_EXTERN_C_END
@@ -7,34 +7,93 @@
  * of patent rights can be found in the PATENTS file in the same directory.
  */
 
+#include <string.h>
+
 #include "YGNodeList.h"
 
 extern YGMalloc gYGMalloc;
 extern YGRealloc gYGRealloc;
 extern YGFree gYGFree;
 
+// Small child lists, which are by far the most common, live entirely in the
+// list allocation. Larger ones move their items to a separate heap array.
+#define YG_NODE_LIST_INLINE_CAPACITY 4
+
 struct YGNodeList {
   uint32_t capacity;
   uint32_t count;
   YGNodeRef *items;
+  YGSlabRef slab;
 };
 
+static inline YGNodeRef *YGNodeListInlineItems(const YGNodeListRef list) {
+  return (YGNodeRef *) (list + 1);
+}
+
+static inline bool YGNodeListIsInline(const YGNodeListRef list) {
+  return list->items == YGNodeListInlineItems(list);
+}
+
+size_t YGNodeListSlabItemSize(void) {
+  return sizeof(struct YGNodeList) + sizeof(YGNodeRef) * YG_NODE_LIST_INLINE_CAPACITY;
+}
+
+static void YGNodeListReserve(const YGNodeListRef list, const uint32_t capacity) {
+  if (capacity <= list->capacity) {
+    return;
+  }
+
+  uint32_t newCapacity = list->capacity * 2;
+  if (newCapacity < capacity) {
+    newCapacity = capacity;
+  }
+
+  if (YGNodeListIsInline(list)) {
+    YGNodeRef *items = gYGMalloc(sizeof(YGNodeRef) * newCapacity);
+    YGAssert(items != NULL, "Could not extend allocation for items");
+    memcpy(items, list->items, sizeof(YGNodeRef) * list->count);
+    list->items = items;
+  } else {
+    list->items = gYGRealloc(list->items, sizeof(YGNodeRef) * newCapacity);
+    YGAssert(list->items != NULL, "Could not extend allocation for items");
+  }
+  list->capacity = newCapacity;
+}
+
 YGNodeListRef YGNodeListNew(const uint32_t initialCapacity) {
-  const YGNodeListRef list = gYGMalloc(sizeof(struct YGNodeList));
+  const YGNodeListRef list = gYGMalloc(YGNodeListSlabItemSize());
   YGAssert(list != NULL, "Could not allocate memory for list");
 
-  list->capacity = initialCapacity;
+  list->capacity = YG_NODE_LIST_INLINE_CAPACITY;
+  list->count = 0;
+  list->items = YGNodeListInlineItems(list);
+  list->slab = NULL;
+  YGNodeListReserve(list, initialCapacity);
+
+  return list;
+}
+
+YGNodeListRef YGNodeListNewInSlab(const YGSlabRef slab) {
+  const YGNodeListRef list = YGSlabAlloc(slab);
+
+  list->capacity = YG_NODE_LIST_INLINE_CAPACITY;
   list->count = 0;
-  list->items = gYGMalloc(sizeof(YGNodeRef) * list->capacity);
-  YGAssert(list->items != NULL, "Could not allocate memory for items");
+  list->items = YGNodeListInlineItems(list);
+  list->slab = slab;
 
   return list;
 }
 
 void YGNodeListFree(const YGNodeListRef list) {
   if (list) {
-    gYGFree(list->items);
-    gYGFree(list);
+    if (!YGNodeListIsInline(list)) {
+      gYGFree(list->items);
+    }
+    if (list->slab) {
+      YGSlabRelease(list->slab, list);
+    } else {
+      gYGFree(list);
+    }
   }
 }
 
@@ -47,48 +106,65 @@ uint32_t YGNodeListCount(const YGNodeListRef list) {
 
 void YGNodeListAdd(YGNodeListRef *listp, const YGNodeRef node) {
   if (!*listp) {
-    *listp = YGNodeListNew(4);
+    *listp = YGNodeListNew(YG_NODE_LIST_INLINE_CAPACITY);
   }
   YGNodeListInsert(listp, node, (*listp)->count);
 }
 
 void YGNodeListInsert(YGNodeListRef *listp, const YGNodeRef node, const uint32_t index) {
-  if (!*listp) {
-    *listp = YGNodeListNew(4);
-  }
-  YGNodeListRef list = *listp;
-
-  if (list->count == list->capacity) {
-    list->capacity *= 2;
-    list->items = gYGRealloc(list->items, sizeof(YGNodeRef) * list->capacity);
-    YGAssert(list->items != NULL, "Could not extend allocation for items");
-  }
+  YGNodeListInsertRange(listp, &node, 1, index);
+}
 
-  for (uint32_t i = list->count; i > index; i--) {
-    list->items[i] = list->items[i - 1];
+void YGNodeListInsertRange(YGNodeListRef *listp,
+                           const YGNodeRef nodes[],
+                           const uint32_t count,
+                           const uint32_t index) {
+  if (!*listp) {
+    *listp = YGNodeListNew(count);
   }
-
-  list->count++;
-  list->items[index] = node;
+  const YGNodeListRef list = *listp;
+  YGAssert(index <= list->count, "Cannot insert past the end of the list");
+
+  YGNodeListReserve(list, list->count + count);
+  memmove(&list->items[index + count],
+          &list->items[index],
+          sizeof(YGNodeRef) * (list->count - index));
+  memcpy(&list->items[index], nodes, sizeof(YGNodeRef) * count);
+  list->count += count;
 }
 
 YGNodeRef YGNodeListRemove(const YGNodeListRef list, const uint32_t index) {
   const YGNodeRef removed = list->items[index];
-  list->items[index] = NULL;
 
-  for (uint32_t i = index; i < list->count - 1; i++) {
-    list->items[i] = list->items[i + 1];
-    list->items[i + 1] = NULL;
-  }
+  memmove(&list->items[index],
+          &list->items[index + 1],
+          sizeof(YGNodeRef) * (list->count - index - 1));
 
   list->count--;
   return removed;
 }
 
+YGNodeRef YGNodeListReplace(const YGNodeListRef list, const uint32_t index, const YGNodeRef node) {
+  const YGNodeRef replaced = list->items[index];
+  list->items[index] = node;
+  return replaced;
+}
+
+void YGNodeListRemoveAll(const YGNodeListRef list) {
+  if (list) {
+    list->count = 0;
+  }
+}
+
 YGNodeRef YGNodeListDelete(const YGNodeListRef list, const YGNodeRef node) {
-  for (uint32_t i = 0; i < list->count; i++) {
-    if (list->items[i] == node) {
-      return YGNodeListRemove(list, i);
+  if (!list) {
+    return NULL;
+  }
+
+  // Children are most often removed from the end, so search from there.
+  for (uint32_t i = list->count; i > 0; i--) {
+    if (list->items[i - 1] == node) {
+      return YGNodeListRemove(list, i - 1);
     }
   }
 
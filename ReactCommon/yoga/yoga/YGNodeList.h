@@ -15,18 +15,29 @@
 #include <stdlib.h>
 
 #include "YGMacros.h"
+#include "YGSlab.h"
 #include "Yoga.h"
 
 YG_EXTERN_C_BEGIN
 
 typedef struct YGNodeList *YGNodeListRef;
 
+// Lists keep their first few items inline, in the list allocation itself.
 YGNodeListRef YGNodeListNew(const uint32_t initialCapacity);
+// The slab must be created with YGNodeListSlabItemSize().
+YGNodeListRef YGNodeListNewInSlab(const YGSlabRef slab);
+size_t YGNodeListSlabItemSize(void);
 void YGNodeListFree(const YGNodeListRef list);
 uint32_t YGNodeListCount(const YGNodeListRef list);
 void YGNodeListAdd(YGNodeListRef *listp, const YGNodeRef node);
 void YGNodeListInsert(YGNodeListRef *listp, const YGNodeRef node, const uint32_t index);
+void YGNodeListInsertRange(YGNodeListRef *listp,
+                           const YGNodeRef nodes[],
+                           const uint32_t count,
+                           const uint32_t index);
 YGNodeRef YGNodeListRemove(const YGNodeListRef list, const uint32_t index);
+YGNodeRef YGNodeListReplace(const YGNodeListRef list, const uint32_t index, const YGNodeRef node);
+void YGNodeListRemoveAll(const YGNodeListRef list);
 YGNodeRef YGNodeListDelete(const YGNodeListRef list, const YGNodeRef node);
 YGNodeRef YGNodeListGet(const YGNodeListRef list, const uint32_t index);
 
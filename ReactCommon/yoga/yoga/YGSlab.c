@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include "YGSlab.h"
+#include "Yoga.h"
+
+#include <pthread.h>
+
+extern YGMalloc gYGMalloc;
+extern YGFree gYGFree;
+
+// Items and block headers are padded to this, which is enough for any of the
+// structs allocated from a slab.
+#define YG_SLAB_ALIGNMENT 16
+#define YG_SLAB_ALIGN(size) (((size) + YG_SLAB_ALIGNMENT - 1) & ~(size_t)(YG_SLAB_ALIGNMENT - 1))
+
+typedef struct YGSlabBlock {
+  struct YGSlabBlock *next;
+} YGSlabBlock;
+
+typedef struct YGSlabFreeItem {
+  struct YGSlabFreeItem *next;
+} YGSlabFreeItem;
+
+struct YGSlab {
+  size_t itemSize;
+  uint32_t itemsPerBlock;
+  // Guards everything below. Trees built on different threads may share a
+  // config, and with it its slabs.
+  pthread_mutex_t lock;
+  uint32_t liveCount;
+  YGSlabBlock *blocks;
+  YGSlabFreeItem *freeList;
+};
+
+YGSlabRef YGSlabNew(const size_t itemSize, const uint32_t itemsPerBlock) {
+  YGAssert(itemsPerBlock > 0, "Slab blocks must hold at least one item");
+  const YGSlabRef slab = gYGMalloc(sizeof(struct YGSlab));
+  YGAssert(slab != NULL, "Could not allocate memory for slab");
+
+  slab->itemSize = YG_SLAB_ALIGN(itemSize < sizeof(YGSlabFreeItem) ? sizeof(YGSlabFreeItem) : itemSize);
+  slab->itemsPerBlock = itemsPerBlock;
+  pthread_mutex_init(&slab->lock, NULL);
+  slab->liveCount = 0;
+  slab->blocks = NULL;
+  slab->freeList = NULL;
+  return slab;
+}
+
+void YGSlabFree(const YGSlabRef slab) {
+  if (slab) {
+    YGSlabBlock *block = slab->blocks;
+    while (block) {
+      YGSlabBlock *next = block->next;
+      gYGFree(block);
+      block = next;
+    }
+    pthread_mutex_destroy(&slab->lock);
+    gYGFree(slab);
+  }
+}
+
+static void YGSlabGrow(const YGSlabRef slab) {
+  const size_t headerSize = YG_SLAB_ALIGN(sizeof(YGSlabBlock));
+  YGSlabBlock *block = gYGMalloc(headerSize + slab->itemSize * slab->itemsPerBlock);
+  YGAssert(block != NULL, "Could not allocate memory for slab block");
+
+  block->next = slab->blocks;
+  slab->blocks = block;
+
+  // Thread the new items onto the free list so that they are handed out in
+  // address order.
+  char *items = (char *) block + headerSize;
+  for (uint32_t i = slab->itemsPerBlock; i > 0; i--) {
+    YGSlabFreeItem *item = (YGSlabFreeItem *) (items + slab->itemSize * (i - 1));
+    item->next = slab->freeList;
+    slab->freeList = item;
+  }
+}
+
+void *YGSlabAlloc(const YGSlabRef slab) {
+  pthread_mutex_lock(&slab->lock);
+  if (!slab->freeList) {
+    YGSlabGrow(slab);
+  }
+
+  YGSlabFreeItem *item = slab->freeList;
+  slab->freeList = item->next;
+  slab->liveCount++;
+  pthread_mutex_unlock(&slab->lock);
+  return item;
+}
+
+void YGSlabRelease(const YGSlabRef slab, void *item) {
+  YGSlabFreeItem *freeItem = (YGSlabFreeItem *) item;
+  pthread_mutex_lock(&slab->lock);
+  freeItem->next = slab->freeList;
+  slab->freeList = freeItem;
+  slab->liveCount--;
+  pthread_mutex_unlock(&slab->lock);
+}
+
+uint32_t YGSlabLiveCount(const YGSlabRef slab) {
+  pthread_mutex_lock(&slab->lock);
+  const uint32_t liveCount = slab->liveCount;
+  pthread_mutex_unlock(&slab->lock);
+  return liveCount;
+}
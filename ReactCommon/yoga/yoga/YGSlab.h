@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "YGMacros.h"
+
+YG_EXTERN_C_BEGIN
+
+// Fixed-size allocator handing out items from large blocks. Freed items are
+// kept on a free list for reuse; blocks are only returned by YGSlabFree.
+// Items may be allocated and released from any thread.
+typedef struct YGSlab *YGSlabRef;
+
+YGSlabRef YGSlabNew(const size_t itemSize, const uint32_t itemsPerBlock);
+void YGSlabFree(const YGSlabRef slab);
+void *YGSlabAlloc(const YGSlabRef slab);
+void YGSlabRelease(const YGSlabRef slab, void *item);
+uint32_t YGSlabLiveCount(const YGSlabRef slab);
+
+YG_EXTERN_C_END
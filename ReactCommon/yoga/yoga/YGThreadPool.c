@@ -0,0 +1,261 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include "YGThreadPool.h"
+#include "Yoga.h"
+
+extern YGMalloc gYGMalloc;
+extern YGFree gYGFree;
+
+#ifndef _WIN32
+#define YG_HAVE_PTHREADS 1
+#include <pthread.h>
+#endif
+
+#if YG_HAVE_PTHREADS
+
+typedef struct YGTaskRange {
+  pthread_mutex_t lock;
+  uint32_t begin;
+  uint32_t end;
+} YGTaskRange;
+
+typedef struct YGWorker {
+  struct YGThreadPool *pool;
+  uint32_t index;
+  pthread_t thread;
+} YGWorker;
+
+struct YGThreadPool {
+  uint32_t threadCount;
+  YGWorker *workers;
+  // One range per worker, plus a last one for the thread calling
+  // YGThreadPoolRun.
+  YGTaskRange *ranges;
+
+  // Held for a whole batch, so that callers laying out separate trees with a
+  // shared config take turns.
+  pthread_mutex_t runLock;
+  pthread_mutex_t lock;
+  pthread_cond_t workAvailable;
+  pthread_cond_t workDone;
+  uint64_t batch;
+  uint32_t busyWorkers;
+  bool shuttingDown;
+
+  YGThreadPoolTaskFunc task;
+  void *context;
+};
+
+static bool YGTaskRangePopBack(YGTaskRange *range, uint32_t *index) {
+  pthread_mutex_lock(&range->lock);
+  const bool found = range->begin < range->end;
+  if (found) {
+    *index = --range->end;
+  }
+  pthread_mutex_unlock(&range->lock);
+  return found;
+}
+
+static bool YGTaskRangeStealFront(YGTaskRange *range, uint32_t *index) {
+  pthread_mutex_lock(&range->lock);
+  const bool found = range->begin < range->end;
+  if (found) {
+    *index = range->begin++;
+  }
+  pthread_mutex_unlock(&range->lock);
+  return found;
+}
+
+// Tasks never add more tasks, so once every range is empty the batch only
+// waits for calls already in progress.
+static void YGThreadPoolDrain(const YGThreadPoolRef pool, const uint32_t self) {
+  const uint32_t participants = pool->threadCount + 1;
+  uint32_t index;
+  for (;;) {
+    if (YGTaskRangePopBack(&pool->ranges[self], &index)) {
+      pool->task(pool->context, index);
+      continue;
+    }
+
+    bool stole = false;
+    for (uint32_t i = 1; i < participants && !stole; i++) {
+      stole = YGTaskRangeStealFront(&pool->ranges[(self + i) % participants], &index);
+    }
+    if (!stole) {
+      return;
+    }
+    pool->task(pool->context, index);
+  }
+}
+
+static void *YGWorkerMain(void *arg) {
+  YGWorker *const worker = arg;
+  const YGThreadPoolRef pool = worker->pool;
+  uint64_t lastBatch = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (!pool->shuttingDown && pool->batch == lastBatch) {
+      pthread_cond_wait(&pool->workAvailable, &pool->lock);
+    }
+    if (pool->shuttingDown) {
+      break;
+    }
+    lastBatch = pool->batch;
+    pthread_mutex_unlock(&pool->lock);
+
+    YGThreadPoolDrain(pool, worker->index);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->busyWorkers == 0) {
+      pthread_cond_signal(&pool->workDone);
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+YGThreadPoolRef YGThreadPoolNew(const uint32_t threadCount) {
+  const YGThreadPoolRef pool = gYGMalloc(sizeof(struct YGThreadPool));
+  YGAssert(pool != NULL, "Could not allocate memory for thread pool");
+
+  pool->threadCount = threadCount;
+  pool->workers = gYGMalloc(sizeof(YGWorker) * threadCount);
+  pool->ranges = gYGMalloc(sizeof(YGTaskRange) * (threadCount + 1));
+  YGAssert(pool->workers != NULL && pool->ranges != NULL,
+           "Could not allocate memory for thread pool");
+
+  pthread_mutex_init(&pool->runLock, NULL);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->workAvailable, NULL);
+  pthread_cond_init(&pool->workDone, NULL);
+  pool->batch = 0;
+  pool->busyWorkers = 0;
+  pool->shuttingDown = false;
+  pool->task = NULL;
+  pool->context = NULL;
+
+  for (uint32_t i = 0; i <= threadCount; i++) {
+    pthread_mutex_init(&pool->ranges[i].lock, NULL);
+    pool->ranges[i].begin = 0;
+    pool->ranges[i].end = 0;
+  }
+
+  for (uint32_t i = 0; i < threadCount; i++) {
+    pool->workers[i].pool = pool;
+    pool->workers[i].index = i;
+    const int error = pthread_create(&pool->workers[i].thread, NULL, &YGWorkerMain, &pool->workers[i]);
+    YGAssert(error == 0, "Could not start layout thread");
+  }
+
+  return pool;
+}
+
+void YGThreadPoolFree(const YGThreadPoolRef pool) {
+  if (!pool) {
+    return;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  pool->shuttingDown = true;
+  pthread_cond_broadcast(&pool->workAvailable);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (uint32_t i = 0; i < pool->threadCount; i++) {
+    pthread_join(pool->workers[i].thread, NULL);
+  }
+  for (uint32_t i = 0; i <= pool->threadCount; i++) {
+    pthread_mutex_destroy(&pool->ranges[i].lock);
+  }
+  pthread_cond_destroy(&pool->workDone);
+  pthread_cond_destroy(&pool->workAvailable);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_mutex_destroy(&pool->runLock);
+
+  gYGFree(pool->ranges);
+  gYGFree(pool->workers);
+  gYGFree(pool);
+}
+
+void YGThreadPoolRun(const YGThreadPoolRef pool,
+                     const YGThreadPoolTaskFunc task,
+                     void *context,
+                     const uint32_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  if (pool->threadCount == 0 || count == 1) {
+    for (uint32_t i = 0; i < count; i++) {
+      task(context, i);
+    }
+    return;
+  }
+
+  pthread_mutex_lock(&pool->runLock);
+
+  const uint32_t participants = pool->threadCount + 1;
+  pool->task = task;
+  pool->context = context;
+  for (uint32_t i = 0; i < participants; i++) {
+    // Workers only look at their range after taking pool->lock below.
+    pool->ranges[i].begin = (uint32_t)((uint64_t) count * i / participants);
+    pool->ranges[i].end = (uint32_t)((uint64_t) count * (i + 1) / participants);
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  pool->busyWorkers = pool->threadCount;
+  pool->batch++;
+  pthread_cond_broadcast(&pool->workAvailable);
+  pthread_mutex_unlock(&pool->lock);
+
+  YGThreadPoolDrain(pool, pool->threadCount);
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->busyWorkers > 0) {
+    pthread_cond_wait(&pool->workDone, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  pthread_mutex_unlock(&pool->runLock);
+}
+
+#else
+
+// Without pthreads every batch runs on the calling thread.
+struct YGThreadPool {
+  uint32_t threadCount;
+};
+
+YGThreadPoolRef YGThreadPoolNew(const uint32_t threadCount) {
+  const YGThreadPoolRef pool = gYGMalloc(sizeof(struct YGThreadPool));
+  YGAssert(pool != NULL, "Could not allocate memory for thread pool");
+  pool->threadCount = 0;
+  return pool;
+}
+
+void YGThreadPoolFree(const YGThreadPoolRef pool) {
+  gYGFree(pool);
+}
+
+void YGThreadPoolRun(const YGThreadPoolRef pool,
+                     const YGThreadPoolTaskFunc task,
+                     void *context,
+                     const uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    task(context, i);
+  }
+}
+
+#endif
+
+uint32_t YGThreadPoolGetThreadCount(const YGThreadPoolRef pool) {
+  return pool->threadCount;
+}
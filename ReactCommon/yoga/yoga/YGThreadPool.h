@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "YGMacros.h"
+
+YG_EXTERN_C_BEGIN
+
+// Fixed set of worker threads running batches of independent tasks. Each
+// participant starts with a contiguous share of the batch and steals from the
+// others once its own share is done.
+typedef struct YGThreadPool *YGThreadPoolRef;
+typedef void (*YGThreadPoolTaskFunc)(void *context, const uint32_t index);
+
+YGThreadPoolRef YGThreadPoolNew(const uint32_t threadCount);
+void YGThreadPoolFree(const YGThreadPoolRef pool);
+uint32_t YGThreadPoolGetThreadCount(const YGThreadPoolRef pool);
+
+// Calls task(context, i) for every i below count and returns once all calls
+// have finished. The calling thread takes part in the work. Batches run from
+// several threads on the same pool are run one after the other.
+void YGThreadPoolRun(const YGThreadPoolRef pool,
+                     const YGThreadPoolTaskFunc task,
+                     void *context,
+                     const uint32_t count);
+
+YG_EXTERN_C_END
@@ -78,10 +78,42 @@ WIN_EXPORT void YGNodeInsertChild(const YGNodeRef node,
                                   const YGNodeRef child,
                                   const uint32_t index);
 WIN_EXPORT void YGNodeRemoveChild(const YGNodeRef node, const YGNodeRef child);
+
+// Bulk variants of the above. Each marks the node dirty at most once, however
+// many children it touches. YGNodeSetChildren may keep some of the current
+// children, in any order; all other children must not have a parent.
+WIN_EXPORT void YGNodeInsertChildren(const YGNodeRef node,
+                                     const YGNodeRef children[],
+                                     const uint32_t count,
+                                     const uint32_t index);
+WIN_EXPORT void YGNodeSetChildren(const YGNodeRef node,
+                                  const YGNodeRef children[],
+                                  const uint32_t count);
+WIN_EXPORT void YGNodeRemoveAllChildren(const YGNodeRef node);
+
 WIN_EXPORT YGNodeRef YGNodeGetChild(const YGNodeRef node, const uint32_t index);
 WIN_EXPORT YGNodeRef YGNodeGetParent(const YGNodeRef node);
 WIN_EXPORT uint32_t YGNodeGetChildCount(const YGNodeRef node);
 
+// Copy-on-write cloning, to lay out a new version of a tree on one thread while
+// another keeps reading the last one. YGNodeClone copies a node but shares its
+// children, which stay owned by the original tree and report changes to it.
+// Before changing a shared node, copy the path to it down from the clone with
+// YGNodeCloneChild, which returns the child at index after copying it if it
+// is still shared. Layout copies the shared children it has to write to by
+// itself, so subtrees which are neither changed nor laid out again stay
+// shared. Changing, laying out or freeing a shared node is an error.
+//
+// Only the newest version may be changed or laid out, by one thread at a
+// time. Older versions may be read from other threads meanwhile, but never
+// laid out: that would copy the nodes they share too, racing with the newest
+// version doing the same. Once the new version is laid out, publish it by
+// swapping the root the readers use, with an atomic store. Free the old
+// version with YGNodeFreeRecursive once they are done with it, on the thread
+// changing the new version: nodes still held by the new version are kept.
+WIN_EXPORT YGNodeRef YGNodeClone(const YGNodeRef node);
+WIN_EXPORT YGNodeRef YGNodeCloneChild(const YGNodeRef node, const uint32_t index);
+
 WIN_EXPORT void YGNodeCalculateLayout(const YGNodeRef node,
                                       const float availableWidth,
                                       const float availableHeight,
@@ -98,6 +130,31 @@ WIN_EXPORT bool YGNodeIsDirty(const YGNodeRef node);
 
 WIN_EXPORT void YGNodePrint(const YGNodeRef node, const YGPrintOptions options);
 
+// Writes a compact binary snapshot of the tree under node: its config, the
+// style of every node and, if includeLayout, their computed and cached layout.
+// Returns the size of the snapshot, only writing it if it fits in capacity, so
+// that a first call with a NULL buffer can size it. Snapshots are only read
+// back on machines of the same byte order.
+WIN_EXPORT size_t YGNodeSerialize(const YGNodeRef node,
+                                  const bool includeLayout,
+                                  void *const buffer,
+                                  const size_t capacity);
+
+// Builds a new tree from a snapshot, with every node using config. Functions
+// can't be serialized, so leaves that had a measure function get measureFunc,
+// and nodes that had a baseline function lose it and are laid out again.
+// Other restored layouts are kept valid: laying out the tree again under the
+// same constraints is a cache hit. Returns NULL if the snapshot is malformed
+// or more than 1024 levels deep.
+WIN_EXPORT YGNodeRef YGNodeDeserialize(const void *const data,
+                                       const size_t size,
+                                       const YGConfigRef config,
+                                       const YGMeasureFunc measureFunc);
+
+// A new config with the settings a snapshot was taken with, or NULL if it is
+// malformed. Loggers, caches and parallel layout are not part of snapshots.
+WIN_EXPORT YGConfigRef YGConfigNewFromSnapshot(const void *const data, const size_t size);
+
 WIN_EXPORT bool YGFloatIsUndefined(const float value);
 
 WIN_EXPORT bool YGNodeCanUseCachedMeasurement(const YGMeasureMode widthMode,
@@ -161,6 +218,11 @@ YG_NODE_PROPERTY(YGMeasureFunc, MeasureFunc, measureFunc);
 YG_NODE_PROPERTY(YGBaselineFunc, BaselineFunc, baselineFunc)
 YG_NODE_PROPERTY(YGPrintFunc, PrintFunc, printFunc);
 YG_NODE_PROPERTY(bool, HasNewLayout, hasNewLayout);
+// Identifies what the node's measure function measures, such as a hash of its text and text
+// style, for the config's measure cache. Nodes with equal keys and the same measure function
+// must measure the same under the same constraints. 0, the default, keeps the node out of the
+// cache. Changing the key does not mark the node dirty.
+YG_NODE_PROPERTY(uint64_t, MeasureCacheKey, measureCacheKey);
 
 YG_NODE_STYLE_PROPERTY(YGDirection, Direction, direction);
 YG_NODE_STYLE_PROPERTY(YGFlexDirection, FlexDirection, flexDirection);
@@ -206,6 +268,22 @@ YG_NODE_STYLE_PROPERTY_UNIT(YGValue, MaxHeight, maxHeight);
 // - Aspect ratio takes min/max dimensions into account
 YG_NODE_STYLE_PROPERTY(float, AspectRatio, aspectRatio);
 
+// One style change for YGNodeApplyStyleBatch. Enum properties take their value as a float, edge
+// is only read for edge properties and unit only for properties accepting units. YGUnitUndefined
+// resets the property.
+typedef struct YGStyleUpdate {
+  YGNodeRef node;
+  YGStyleProperty property;
+  YGEdge edge;
+  YGUnit unit;
+  float value;
+} YGStyleUpdate;
+
+// Applies count style changes in order, as the matching YGNodeStyleSet functions would, except
+// that nodes are only marked dirty by changes to a different value. Returns the number of such
+// changes.
+WIN_EXPORT uint32_t YGNodeApplyStyleBatch(const YGStyleUpdate *const updates, const uint32_t count);
+
 YG_NODE_LAYOUT_PROPERTY(float, Left);
 YG_NODE_LAYOUT_PROPERTY(float, Top);
 YG_NODE_LAYOUT_PROPERTY(float, Right);
@@ -223,6 +301,8 @@ YG_NODE_LAYOUT_EDGE_PROPERTY(float, Border);
 YG_NODE_LAYOUT_EDGE_PROPERTY(float, Padding);
 
 WIN_EXPORT void YGConfigSetLogger(const YGConfigRef config, YGLogger logger);
+// Print the tree after each YGNodeCalculateLayout call on nodes using this config.
+WIN_EXPORT void YGConfigSetPrintTreeFlag(const YGConfigRef config, const bool enabled);
 WIN_EXPORT void YGLog(const YGNodeRef node, YGLogLevel level, const char *message, ...);
 WIN_EXPORT void YGLogWithConfig(const YGConfigRef config, YGLogLevel level, const char *format, ...);
 WIN_EXPORT void YGAssert(const bool condition, const char *message);
@@ -246,6 +326,73 @@ WIN_EXPORT void YGConfigSetUseLegacyStretchBehaviour(const YGConfigRef config,
 
 // YGConfig
 WIN_EXPORT YGConfigRef YGConfigNew(void);
+// Nodes created with the returned config, and their child lists, are carved out of blocks of
+// nodesPerBlock nodes that are only returned to the system when the config is freed. All of its
+// nodes must be freed before the config is. Trees sharing the config may be built and freed on
+// different threads at once; the blocks are locked while nodes are taken from them or returned.
+WIN_EXPORT YGConfigRef YGConfigNewWithSlabAllocator(const uint32_t nodesPerBlock);
+
+// Lays out subtrees whose size is fixed by their parent, such as list cells
+// with an exact width and height, on threadCount threads, one of them being
+// the thread calling YGNodeCalculateLayout. Results are the same as with
+// sequential layout. Set measureFuncsNeedCallingThread if measure functions
+// may only run on the calling thread; subtrees containing them are then not
+// handed to other threads. A threadCount of 1 or less turns this off again.
+// Trees sharing such a config may be laid out concurrently, but take turns on
+// its threads.
+WIN_EXPORT void YGConfigSetParallelLayout(const YGConfigRef config,
+                                          const uint32_t threadCount,
+                                          const bool measureFuncsNeedCallingThread);
+
+typedef struct YGMeasureCacheStats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  uint32_t count;
+  uint32_t capacity;
+} YGMeasureCacheStats;
+
+// Shares the results of measure functions between nodes of this config with the same
+// measure cache key, across layout passes. Up to capacity results are kept, dropping the least
+// recently used ones first. A capacity of 0 turns the cache off again. Clearing the cache also
+// resets its stats.
+WIN_EXPORT void YGConfigSetMeasureCacheCapacity(const YGConfigRef config, const uint32_t capacity);
+WIN_EXPORT void YGConfigClearMeasureCache(const YGConfigRef config);
+WIN_EXPORT YGMeasureCacheStats YGConfigGetMeasureCacheStats(const YGConfigRef config);
+
+// Number of measurement results each node keeps, see
+// YGLayoutStats.cachedMeasurementHits. This value was chosen based on
+// empiracle data. Even the most complicated layouts should not require more
+// than 16 entries to fit within the cache.
+#define YG_MAX_CACHED_RESULT_COUNT 16
+
+typedef struct YGLayoutStats {
+  // Calls to the recursive layout routine, one or more per node in the tree.
+  uint64_t nodesVisited;
+  // Of those, the ones that ran the flexbox algorithm, to position children or
+  // only to size the node.
+  uint64_t layouts;
+  uint64_t measurements;
+  // The ones answered from the node's cached layout, or from each slot of its
+  // cached measurements.
+  uint64_t cachedLayoutHits;
+  uint64_t cachedMeasurementHits[YG_MAX_CACHED_RESULT_COUNT];
+  // And the ones handed to other threads by parallel layout.
+  uint64_t deferredLayouts;
+
+  // Calls to measure functions, results taken from the config's measure cache
+  // instead, and the total time spent in the calls.
+  uint64_t measureCalls;
+  uint64_t measureCacheHits;
+  double measureTimeMs;
+} YGLayoutStats;
+
+typedef void (*YGLayoutStatsFunc)(const YGNodeRef root, const YGLayoutStats *const stats);
+
+// Calls func after each YGNodeCalculateLayout on a tree of this config, with
+// the counts for that pass. Nothing is counted while func is NULL, the default.
+WIN_EXPORT void YGConfigSetLayoutStatsFunc(const YGConfigRef config, YGLayoutStatsFunc func);
+
 WIN_EXPORT void YGConfigFree(const YGConfigRef config);
 WIN_EXPORT void YGConfigCopy(const YGConfigRef dest, const YGConfigRef src);
 WIN_EXPORT int32_t YGConfigGetInstanceCount(void);